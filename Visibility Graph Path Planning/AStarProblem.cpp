@@ -6,6 +6,9 @@
 //  Copyright © 2017 Joshua Wilhelm. All rights reserved.
 //
 
+#include <cmath>
+#include <limits>
+#include <cassert>
 #include "AStarProblem.h"
 
 using namespace std;
@@ -14,7 +17,8 @@ using namespace std;
 //           startStateIn, goalStateIn are valid states in graphIn
 // EFFECTS : Sets the graph, startState, and goalState
 Problem::Problem(const Graph& graphIn, State startStateIn, State goalStateIn)
-: graph(graphIn), startState(startStateIn), goalState(goalStateIn) {}
+: graph(graphIn), startState(startStateIn), goalState(goalStateIn),
+landmarks(nullptr) {}
 
 // EFFECTS : Dynamically creates a root node for the search tree based on
 //           startState
@@ -31,11 +35,66 @@ bool Problem::goalTest(const Tree_Node* checkNode) const {
     return goalState == checkNode->state;
 }
 
+// EFFECTS : Returns startState
+State Problem::getStartState() const {
+    return startState;
+}
+
+// EFFECTS: Returns true if goalState == checkState, false otherwise
+bool Problem::goalTest(const State &checkState) const {
+    return goalState == checkState;
+}
+
+// EFFECTS : Returns the number of vertices in the graph (no search can
+//           reach more states)
+int Problem::numStates() const {
+    return graph.vertices.size();
+}
+
+// REQUIRES: landmarksIn was built from the graph this Problem searches.
+//           goalState is one of the landmarks' vertices or has already
+//           been attached to the graph (see visibleVertices).
+//           landmarksIn outlives this Problem.
+// MODIFIES: this
+// EFFECTS : Makes heuristic use the landmark lower bounds as well as the
+//           straight-line-distance
+void Problem::useLandmarks(const Landmarks &landmarksIn) {
+    landmarks = &landmarksIn;
+    landmarkDistances(landmarksIn, graph, goalState.position,
+                      goalLandmarkDistances);
+}
+
 // EFFECTS : Returns the straight-line-distance from the currentState to the
-//           goalState
+//           goalState. If landmarks are in use, returns the largest of that
+//           and the landmark (triangle inequality) lower bounds.
 double Problem::heuristic(const State &currentState) const {
-    return distanceFormula(*currentState.position, *goalState.position,
-                           DIMENSIONS);
+    double straightLine = distanceFormula(*currentState.position,
+                                          *goalState.position);
+    if (landmarks == nullptr) {
+        return straightLine;
+    }
+    
+    // Start and goal are not in the tables
+    int current = vertexIndex(landmarks->adjacency, currentState.position);
+    if (current == -1) {
+        return straightLine;
+    }
+    
+    const double infinity = numeric_limits<double>::infinity();
+    double best = straightLine;
+    for (int k = 0; k < (int) goalLandmarkDistances.size(); ++k) {
+        double toCurrent = landmarks->distances[k][current];
+        double toGoal = goalLandmarkDistances[k];
+        // No bound from a landmark that cannot reach both
+        if (toCurrent == infinity || toGoal == infinity) {
+            continue;
+        }
+        double bound = fabs(toGoal - toCurrent);
+        if (bound > best) {
+            best = bound;
+        }
+    }
+    return best;
 }
 
 // EFFECTS : Adds the states that can be traveled to from currentState to
@@ -79,3 +138,21 @@ void Problem::printSolution(vector<State> &solution, ostream &os) const {
         }
     }
 }
+
+// REQUIRES: adjacencyIn was built from a graph with startIn and goalIn
+//           attached (see visibleVertices), adjacencyIn outlives this
+// EFFECTS : Sets the graph, start, and goal
+AdjacencyProblem::AdjacencyProblem(const AdjacencyGraph &adjacencyIn,
+                                   const Vertex *startIn,
+                                   const Vertex *goalIn)
+: adjacency(adjacencyIn), start(vertexIndex(adjacencyIn, startIn)),
+goal(vertexIndex(adjacencyIn, goalIn)) {
+    assert(start != -1 && goal != -1);
+}
+
+// REQUIRES: problemIn searches from startIn to goalIn, problemIn
+//           outlives this
+// EFFECTS : Sets the problem, start, and goal
+ProblemAdapter::ProblemAdapter(const Problem &problemIn, State startIn,
+                               State goalIn)
+: problem(problemIn), start(startIn), goal(goalIn) {}
@@ -14,7 +14,10 @@
 
 #include <vector>
 #include <iostream>
+#include <functional>
 #include "preprocessing.h"
+#include "adjacency.h"
+#include "landmarks.h"
 #include "Tree_Node.h"
 
 class Problem {
@@ -23,6 +26,11 @@ private:
     State startState;
     State goalState;
     
+    // Optional ALT tables (nullptr if only the straight line is used)
+    const Landmarks *landmarks;
+    // Distance from each landmark to goalState
+    std::vector<double> goalLandmarkDistances;
+    
 public:
     // REQUIRES: graphIn has been pre-processed and is ready for searching
     //           startStateIn, goalStateIn are valid states in graphIn
@@ -36,8 +44,28 @@ public:
     // EFFECTS: Returns true if goalState == checkNode->state, false otherwise
     bool goalTest(const Tree_Node* checkNode) const;
     
+    // EFFECTS : Returns startState
+    State getStartState() const;
+    
+    // EFFECTS: Returns true if goalState == checkState, false otherwise
+    bool goalTest(const State &checkState) const;
+    
+    // EFFECTS : Returns the number of vertices in the graph (no search can
+    //           reach more states)
+    int numStates() const;
+    
+    // REQUIRES: landmarksIn was built from the graph this Problem searches.
+    //           goalState is one of the landmarks' vertices or has already
+    //           been attached to the graph (see visibleVertices).
+    //           landmarksIn outlives this Problem.
+    // MODIFIES: this
+    // EFFECTS : Makes heuristic use the landmark lower bounds as well as the
+    //           straight-line-distance
+    void useLandmarks(const Landmarks &landmarksIn);
+    
     // EFFECTS : Returns the straight-line-distance from the currentState to the
-    //           goalState
+    //           goalState. If landmarks are in use, returns the largest of that
+    //           and the landmark (triangle inequality) lower bounds.
     double heuristic(const State &currentState) const;
     
     // EFFECTS : Adds the states that can be traveled to from currentState to
@@ -54,4 +82,106 @@ public:
     void printSolution(std::vector<State> &solution, std::ostream &os) const;
 };
 
+// Problem type for policySearch (see search_engine.h) on an indexed graph.
+// States are vertex numbers in the AdjacencyGraph, so every callback is a few
+// inline instructions.
+class AdjacencyProblem {
+private:
+    const AdjacencyGraph &adjacency;
+    int start;
+    int goal;
+    
+public:
+    typedef int StateType;
+    typedef std::hash<int> StateHasher;
+    
+    // REQUIRES: adjacencyIn was built from a graph with startIn and goalIn
+    //           attached (see visibleVertices), adjacencyIn outlives this
+    // EFFECTS : Sets the graph, start, and goal
+    AdjacencyProblem(const AdjacencyGraph &adjacencyIn, const Vertex *startIn,
+                     const Vertex *goalIn);
+    
+    int startState() const {
+        return start;
+    }
+    
+    bool isGoal(int s) const {
+        return s == goal;
+    }
+    
+    // EFFECTS : Returns the straight-line-distance from s to the goal
+    double heuristic(int s) const {
+        return distanceFormula(*adjacency.vertices[s],
+                               *adjacency.vertices[goal]);
+    }
+    
+    // EFFECTS : Calls visit(neighbor, edgeLength) for every neighbor of s
+    template <class Visit>
+    void forEachSuccessor(int s, Visit visit) const {
+        const std::vector<Neighbor> &sNeighbors = adjacency.neighbors[s];
+        for (int i = 0; i < (int) sNeighbors.size(); ++i) {
+            visit(sNeighbors[i].vertex, sNeighbors[i].length);
+        }
+    }
+    
+    int numStates() const {
+        return (int) adjacency.vertices.size();
+    }
+    
+    int stateIndex(int s) const {
+        return s;
+    }
+    
+    // EFFECTS : Returns the State of vertex number s
+    State toState(int s) const {
+        return State{adjacency.vertices[s]};
+    }
+};
+
+// Problem type for policySearch that forwards to a Problem, so the policies
+// can be compared on the same callbacks AStarSearch uses (none of which can
+// be inlined)
+class ProblemAdapter {
+private:
+    const Problem &problem;
+    State start;
+    State goal;
+    // Reused by forEachSuccessor
+    mutable std::vector<State> possibleStates;
+    mutable std::vector<double> pathCosts;
+    
+public:
+    typedef State StateType;
+    typedef StateHash StateHasher;
+    
+    // REQUIRES: problemIn searches from startIn to goalIn, problemIn
+    //           outlives this
+    // EFFECTS : Sets the problem, start, and goal
+    ProblemAdapter(const Problem &problemIn, State startIn, State goalIn);
+    
+    State startState() const {
+        return start;
+    }
+    
+    bool isGoal(const State &s) const {
+        return s == goal;
+    }
+    
+    double heuristic(const State &s) const {
+        return problem.heuristic(s);
+    }
+    
+    // EFFECTS : Calls visit(state, pathCost) for every option given by
+    //           Problem::expandOptions
+    template <class Visit>
+    void forEachSuccessor(const State &s, Visit visit) const {
+        possibleStates.clear();
+        pathCosts.clear();
+        problem.expandOptions(possibleStates, pathCosts, s);
+        for (int i = 0; i < (int) possibleStates.size(); ++i) {
+            visit(possibleStates[i], pathCosts[i]);
+        }
+    }
+};
+
 #endif /* AStarProblem_h */
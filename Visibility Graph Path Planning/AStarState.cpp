@@ -6,6 +6,7 @@
 //  Copyright © 2017 Joshua Wilhelm. All rights reserved.
 //
 
+#include <functional>
 #include "AStarState.h"
 
 using namespace std;
@@ -14,3 +15,15 @@ using namespace std;
 bool operator==(const State &lhs, const State &rhs) {
     return (*(lhs.position) == *(rhs.position));
 }
+
+// Hash function for States, for use in unordered containers. Equal states
+// (see operator==) must hash equally, so this hashes the coordinates rather
+// than the pointer.
+size_t StateHash::operator()(const State &s) const {
+    size_t seed = 0;
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        seed ^= hash<double>()(s.position->coord[i]) + 0x9e3779b9 +
+                (seed << 6) + (seed >> 2);
+    }
+    return seed;
+}
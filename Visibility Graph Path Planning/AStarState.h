@@ -9,6 +9,7 @@
 #ifndef AStarState_h
 #define AStarState_h
 
+#include <cstddef>
 #include "preprocessing.h"
 
 // Shallow copies ok (just a pointer, owned elsewhere anyway)
@@ -19,4 +20,11 @@ struct State {
 // EFFECTS : Returns true if lhs and rhs are the same state
 bool operator==(const State &lhs, const State &rhs);
 
+// Hash function for States, for use in unordered containers. Equal states
+// (see operator==) must hash equally, so this hashes the coordinates rather
+// than the pointer.
+struct StateHash {
+    size_t operator()(const State &s) const;
+};
+
 #endif /* AStarState_h */
@@ -87,6 +87,14 @@ public:
     // Removes the node with data == delPtr and returns its data
     T* removeValue(T* delPtr);
     
+    // REQUIRES: predicate can be called with a T* and returns bool
+    // MODIFIES: this, may invalidate list iterators
+    // EFFECTS : Removes every node whose data satisfies predicate, in one pass.
+    //           Also deletes that data if owner_of_data is true. Returns the
+    //           number of nodes removed.
+    template <typename Predicate>
+    int removeIf(Predicate predicate);
+    
     // Pre-iterator functions
 //    // EFFECTS : returns the data member of the first item in the List, returns
 //    //           the null pointer if List is empty
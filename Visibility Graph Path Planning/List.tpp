@@ -275,6 +275,11 @@ T* List<T>::removeValue(T* delPtr) {
     // Check if empty list
     assert(head != nullptr);
     
+    // Value at start of list (removeStart updates the size)
+    if (head->data == delPtr) {
+        return removeStart();
+    }
+    
     // Decrement size
     --List_size;
     
@@ -283,11 +288,6 @@ T* List<T>::removeValue(T* delPtr) {
         return deleteSingleNode();
     }
     
-    // Value at start of list
-    if (head->data == delPtr) {
-        return removeStart();
-    }
-    
     List_Node *current = head;
     List_Node *after = current->next;
     
@@ -301,6 +301,8 @@ T* List<T>::removeValue(T* delPtr) {
     if (after->data == delPtr) {
         // Call removeEnd for special procedure if deleting tail node
         if (after == tail) {
+            // removeEnd updates the size
+            ++List_size;
             return removeEnd();
         }
         
@@ -313,6 +315,44 @@ T* List<T>::removeValue(T* delPtr) {
     assert(false);
 }
 
+// REQUIRES: predicate can be called with a T* and returns bool
+// MODIFIES: this, may invalidate list iterators
+// EFFECTS : Removes every node whose data satisfies predicate, in one pass.
+//           Also deletes that data if owner_of_data is true. Returns the
+//           number of nodes removed.
+template <typename T>
+template <typename Predicate>
+int List<T>::removeIf(Predicate predicate) {
+    int removed = 0;
+    List_Node *previous = nullptr;
+    List_Node *current = head;
+    
+    while (current != nullptr) {
+        List_Node *after = current->next;
+        if (predicate(current->data)) {
+            // Unlink current
+            if (previous == nullptr) {
+                head = after;
+            } else {
+                previous->next = after;
+            }
+            if (current == tail) {
+                tail = previous;
+            }
+            if (owner_of_data) {
+                delete current->data;
+            }
+            delete current;
+            --List_size;
+            ++removed;
+        } else {
+            previous = current;
+        }
+        current = after;
+    }
+    return removed;
+}
+
 // Pre-iterator functions
 //// EFFECTS : returns the data member of the first item in the List, returns the
 ////           null pointer if List is empty
@@ -0,0 +1,143 @@
+//
+//  adjacency.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <limits>
+#include <queue>
+#include <functional>
+#include "adjacency.h"
+
+using namespace std;
+
+// REQUIRES: graph is a valid Graph, adjacency is empty
+// MODIFIES: adjacency
+// EFFECTS : Numbers the vertices of graph in list order and fills adjacency
+//           with the neighbors of every vertex (each Edge appears in the
+//           neighbor lists of both endpoints).
+void buildAdjacency(const Graph &graph, AdjacencyGraph &adjacency) {
+    assert(adjacency.vertices.empty());
+
+    adjacency.vertices.reserve(graph.vertices.size());
+    adjacency.neighbors.resize(graph.vertices.size());
+    adjacency.index.reserve(graph.vertices.size());
+
+    // Traversal by Iterator
+    List<Vertex>::Iterator endV = graph.vertices.end();
+    for (List<Vertex>::Iterator v = graph.vertices.begin(); v != endV; ++v) {
+        adjacency.index[*v] = (int) adjacency.vertices.size();
+        adjacency.vertices.push_back(*v);
+    }
+
+    List<Edge>::Iterator endE = graph.connections.end();
+    for (List<Edge>::Iterator e = graph.connections.begin(); e != endE; ++e) {
+        int i1 = vertexIndex(adjacency, (*e)->v1);
+        int i2 = vertexIndex(adjacency, (*e)->v2);
+        // Every edge must connect two vertices of the graph
+        assert(i1 != -1 && i2 != -1);
+
+        adjacency.neighbors[i1].push_back(Neighbor{i2, (*e)->length});
+        adjacency.neighbors[i2].push_back(Neighbor{i1, (*e)->length});
+    }
+}
+
+// EFFECTS : Returns the index of v in adjacency, or -1 if v is not one of its
+//           vertices
+int vertexIndex(const AdjacencyGraph &adjacency, const Vertex *v) {
+    unordered_map<const Vertex*, int>::const_iterator found =
+        adjacency.index.find(v);
+    if (found == adjacency.index.end()) {
+        return -1;
+    }
+    return found->second;
+}
+
+// REQUIRES: attachedEdges are the edges added to a copy of the graph adjacency
+//           was built from when point was attached to it (see the victims
+//           overload of visibleVertices)
+// MODIFIES: neighbors
+// EFFECTS : Sets neighbors to the vertices of adjacency that point can see,
+//           with the distance to each. Edges to vertices outside adjacency
+//           (the other query point) are skipped.
+void attachedNeighbors(const AdjacencyGraph &adjacency,
+                       const List<Edge> &attachedEdges, const Vertex *point,
+                       std::vector<Neighbor> &neighbors) {
+    neighbors.clear();
+
+    List<Edge>::Iterator end = attachedEdges.end();
+    for (List<Edge>::Iterator e = attachedEdges.begin(); e != end; ++e) {
+        const Vertex *other = nullptr;
+        if ((*e)->v1 == point) {
+            other = (*e)->v2;
+        } else if ((*e)->v2 == point) {
+            other = (*e)->v1;
+        } else {
+            continue;
+        }
+
+        int otherIndex = vertexIndex(adjacency, other);
+        if (otherIndex != -1) {
+            neighbors.push_back(Neighbor{otherIndex, (*e)->length});
+        }
+    }
+}
+
+// REQUIRES: 0 <= source < adjacency.vertices.size()
+// MODIFIES: distances, loopCounter
+// EFFECTS : Runs Dijkstra's algorithm from source. distances[i] becomes the
+//           shortest path distance from source to vertex i (infinity if
+//           vertex i cannot be reached). Adds the number of vertices settled
+//           to loopCounter.
+void shortestPaths(const AdjacencyGraph &adjacency, int source,
+                   std::vector<double> &distances, int &loopCounter) {
+    vector<int> previous;
+    shortestPaths(adjacency, source, distances, previous, loopCounter);
+}
+
+// REQUIRES: 0 <= source < adjacency.vertices.size()
+// MODIFIES: distances, previous, loopCounter
+// EFFECTS : Same as above. Also sets previous[i] to the vertex before i on a
+//           shortest path from source (-1 for source and unreachable
+//           vertices).
+void shortestPaths(const AdjacencyGraph &adjacency, int source,
+                   std::vector<double> &distances, std::vector<int> &previous,
+                   int &loopCounter) {
+    const int numVertices = (int) adjacency.vertices.size();
+    assert(source >= 0 && source < numVertices);
+
+    distances.assign(numVertices, numeric_limits<double>::infinity());
+    previous.assign(numVertices, -1);
+
+    // (distance, vertex) pairs, smallest distance on top. Entries made stale
+    // by a later improvement are skipped when popped.
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> queue;
+
+    distances[source] = 0;
+    queue.push(QueueEntry(0, source));
+
+    while (!queue.empty()) {
+        QueueEntry top = queue.top();
+        queue.pop();
+
+        int u = top.second;
+        if (top.first > distances[u]) {
+            // Stale entry
+            continue;
+        }
+
+        ++loopCounter;
+
+        const vector<Neighbor> &uNeighbors = adjacency.neighbors[u];
+        for (int i = 0; i < (int) uNeighbors.size(); ++i) {
+            double newDistance = distances[u] + uNeighbors[i].length;
+            int w = uNeighbors[i].vertex;
+            if (newDistance < distances[w]) {
+                distances[w] = newDistance;
+                previous[w] = u;
+                queue.push(QueueEntry(newDistance, w));
+            }
+        }
+    }
+}
@@ -0,0 +1,76 @@
+//
+//  adjacency.h
+//  Visibility Graph Path Planning
+//
+//  An index-based view of a Graph. Graph stores its edges in a single List,
+//  which is fine for building but makes "who are my neighbors?" an O(E) scan.
+//  The preprocessing-stage query accelerators number the vertices once and
+//  work on plain arrays instead.
+//
+
+#ifndef adjacency_h
+#define adjacency_h
+
+#include <vector>
+#include <unordered_map>
+#include "preprocessing.h"
+
+// One entry in a vertex's neighbor list
+struct Neighbor {
+    // Index of the neighboring vertex in AdjacencyGraph::vertices
+    int vertex;
+    // Length of the edge to the neighboring vertex
+    double length;
+};
+
+// Vertices of a Graph numbered in list order, with the neighbors of each.
+// Does NOT own the vertices (they are still owned by the Graph it was built
+// from).
+struct AdjacencyGraph {
+    std::vector<const Vertex*> vertices;
+    std::vector<std::vector<Neighbor>> neighbors;
+    // Reverse lookup from vertex pointer to index in vertices
+    std::unordered_map<const Vertex*, int> index;
+};
+
+// REQUIRES: graph is a valid Graph, adjacency is empty
+// MODIFIES: adjacency
+// EFFECTS : Numbers the vertices of graph in list order and fills adjacency
+//           with the neighbors of every vertex (each Edge appears in the
+//           neighbor lists of both endpoints).
+void buildAdjacency(const Graph &graph, AdjacencyGraph &adjacency);
+
+// EFFECTS : Returns the index of v in adjacency, or -1 if v is not one of its
+//           vertices
+int vertexIndex(const AdjacencyGraph &adjacency, const Vertex *v);
+
+// REQUIRES: attachedEdges are the edges added to a copy of the graph adjacency
+//           was built from when point was attached to it (see the victims
+//           overload of visibleVertices)
+// MODIFIES: neighbors
+// EFFECTS : Sets neighbors to the vertices of adjacency that point can see,
+//           with the distance to each. Edges to vertices outside adjacency
+//           (the other query point) are skipped.
+void attachedNeighbors(const AdjacencyGraph &adjacency,
+                       const List<Edge> &attachedEdges, const Vertex *point,
+                       std::vector<Neighbor> &neighbors);
+
+// REQUIRES: 0 <= source < adjacency.vertices.size()
+// MODIFIES: distances, loopCounter
+// EFFECTS : Runs Dijkstra's algorithm from source. distances[i] becomes the
+//           shortest path distance from source to vertex i (infinity if
+//           vertex i cannot be reached). Adds the number of vertices settled
+//           to loopCounter.
+void shortestPaths(const AdjacencyGraph &adjacency, int source,
+                   std::vector<double> &distances, int &loopCounter);
+
+// REQUIRES: 0 <= source < adjacency.vertices.size()
+// MODIFIES: distances, previous, loopCounter
+// EFFECTS : Same as above. Also sets previous[i] to the vertex before i on a
+//           shortest path from source (-1 for source and unreachable
+//           vertices).
+void shortestPaths(const AdjacencyGraph &adjacency, int source,
+                   std::vector<double> &distances, std::vector<int> &previous,
+                   int &loopCounter);
+
+#endif /* adjacency_h */
@@ -0,0 +1,34 @@
+//
+//  allocation_counter.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include "allocation_counter.h"
+
+using namespace std;
+
+// Allocations made so far
+static atomic<long> allocations(0);
+
+// EFFECTS : Returns the number of heap allocations (calls to operator new,
+//           from any thread) made so far
+long allocationCount() {
+    return allocations.load(memory_order_relaxed);
+}
+
+// The array and nothrow forms of new and delete call these two
+void * operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    void *memory = malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept {
+    free(memory);
+}
@@ -0,0 +1,20 @@
+//
+//  allocation_counter.h
+//  Visibility Graph Path Planning
+//
+//  Counts heap allocations. This file replaces the global operator new and
+//  operator delete with versions that count every call before handing it to
+//  malloc and free, so a caller can check that a piece of code (such as a
+//  warmed-up SearchContext query) does not allocate. The count is one relaxed
+//  atomic increment per allocation. The replacement applies to the whole
+//  program, so only test programs link this file (see search_context_test).
+//
+
+#ifndef allocation_counter_h
+#define allocation_counter_h
+
+// EFFECTS : Returns the number of heap allocations (calls to operator new,
+//           from any thread) made so far
+long allocationCount();
+
+#endif /* allocation_counter_h */
@@ -0,0 +1,462 @@
+//
+//  contraction.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <limits>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include "contraction.h"
+
+using namespace std;
+
+// Witness searches give up after settling this many vertices. Giving up early
+// only costs an unnecessary shortcut, never a wrong distance.
+static const int WITNESS_SETTLE_LIMIT = 20;
+
+static const double INFINITE_DISTANCE = numeric_limits<double>::infinity();
+
+typedef pair<double, int> QueueEntry;
+typedef priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>>
+    MinQueue;
+
+// Bounded Dijkstra on the part of the graph that has not been contracted yet.
+// Keeps its distance array between searches and only resets the entries the
+// previous search touched.
+class WitnessSearch {
+private:
+    vector<double> distances;
+    vector<int> touched;
+
+public:
+    WitnessSearch(int numVertices)
+    : distances(numVertices, INFINITE_DISTANCE) {}
+
+    // MODIFIES: this, loopCounter
+    // EFFECTS : Finds shortest distances from source in working without
+    //           passing through ignore, stopping at maxDistance or after
+    //           WITNESS_SETTLE_LIMIT settled vertices
+    void run(const vector<vector<HierarchyEdge>> &working, int source,
+             int ignore, double maxDistance, int &loopCounter) {
+        for (int i = 0; i < (int) touched.size(); ++i) {
+            distances[touched[i]] = INFINITE_DISTANCE;
+        }
+        touched.clear();
+
+        MinQueue queue;
+        distances[source] = 0;
+        touched.push_back(source);
+        queue.push(QueueEntry(0, source));
+
+        int settled = 0;
+        while (!queue.empty() && settled < WITNESS_SETTLE_LIMIT) {
+            QueueEntry top = queue.top();
+            queue.pop();
+            int u = top.second;
+            if (top.first > distances[u]) {
+                continue;
+            }
+            if (top.first > maxDistance) {
+                break;
+            }
+            ++settled;
+            ++loopCounter;
+
+            for (int i = 0; i < (int) working[u].size(); ++i) {
+                int w = working[u][i].vertex;
+                if (w == ignore) {
+                    continue;
+                }
+                double newDistance = distances[u] + working[u][i].length;
+                if (newDistance < distances[w]) {
+                    if (distances[w] == INFINITE_DISTANCE) {
+                        touched.push_back(w);
+                    }
+                    distances[w] = newDistance;
+                    queue.push(QueueEntry(newDistance, w));
+                }
+            }
+        }
+    }
+
+    // EFFECTS : Returns the distance found to v by the last run (infinity if
+    //           not reached)
+    double distance(int v) const {
+        return distances[v];
+    }
+};
+
+// MODIFIES: edges
+// EFFECTS : Adds an edge to target, or shortens the existing one if the new
+//           edge is shorter. Returns true if edges changed.
+static bool addOrShorten(vector<HierarchyEdge> &edges, int target,
+                         double length, int middle) {
+    for (int i = 0; i < (int) edges.size(); ++i) {
+        if (edges[i].vertex == target) {
+            if (length < edges[i].length) {
+                edges[i].length = length;
+                edges[i].middle = middle;
+                return true;
+            }
+            return false;
+        }
+    }
+    edges.push_back(HierarchyEdge{target, length, middle});
+    return true;
+}
+
+// REQUIRES: v has not been contracted
+// MODIFIES: working (if addShortcuts), search, loopCounter
+// EFFECTS : Returns the number of shortcuts contracting v requires. If
+//           addShortcuts is true, also adds them to working.
+static int contractVertex(vector<vector<HierarchyEdge>> &working, int v,
+                          bool addShortcuts, WitnessSearch &search,
+                          int &loopCounter) {
+    // Copy, since adding shortcuts may reallocate working[v]'s neighbors
+    const vector<HierarchyEdge> neighbors = working[v];
+    int shortcuts = 0;
+
+    for (int i = 0; i < (int) neighbors.size(); ++i) {
+        int u = neighbors[i].vertex;
+
+        // Longest path through v that a witness would have to beat
+        double maxDistance = 0;
+        for (int j = i + 1; j < (int) neighbors.size(); ++j) {
+            maxDistance = max(maxDistance,
+                              neighbors[i].length + neighbors[j].length);
+        }
+        if (maxDistance == 0) {
+            continue;
+        }
+
+        search.run(working, u, v, maxDistance, loopCounter);
+
+        for (int j = i + 1; j < (int) neighbors.size(); ++j) {
+            int w = neighbors[j].vertex;
+            double throughV = neighbors[i].length + neighbors[j].length;
+            if (search.distance(w) <= throughV) {
+                // Witness found, no shortcut needed
+                continue;
+            }
+            ++shortcuts;
+            if (addShortcuts) {
+                addOrShorten(working[u], w, throughV, v);
+                addOrShorten(working[w], u, throughV, v);
+            }
+        }
+    }
+    return shortcuts;
+}
+
+// EFFECTS : Returns the contraction priority of v (lower is contracted
+//           sooner): edge difference plus number of contracted neighbors
+static int priority(vector<vector<HierarchyEdge>> &working, int v,
+                    const vector<int> &contractedNeighbors,
+                    WitnessSearch &search, int &loopCounter) {
+    int shortcuts = contractVertex(working, v, false, search, loopCounter);
+    return shortcuts - (int) working[v].size() + contractedNeighbors[v];
+}
+
+// REQUIRES: graph has been pre-processed (does not contain start and goal),
+//           hierarchy is empty
+// MODIFIES: hierarchy, loopCounter
+// EFFECTS : Orders the vertices of graph by edge difference (shortcuts added
+//           minus edges removed, updated lazily) and contracts them in that
+//           order, adding a shortcut between two neighbors of a contracted
+//           vertex whenever a bounded witness search finds no path that is at
+//           least as short. Adds the number of vertices settled by witness
+//           searches to loopCounter.
+void buildContractionHierarchy(const Graph &graph,
+                               ContractionHierarchy &hierarchy,
+                               int &loopCounter) {
+    assert(hierarchy.rank.empty());
+
+    buildAdjacency(graph, hierarchy.adjacency);
+    const int numVertices = (int) hierarchy.adjacency.vertices.size();
+
+    hierarchy.rank.assign(numVertices, -1);
+    hierarchy.upward.resize(numVertices);
+    hierarchy.downward.resize(numVertices);
+    hierarchy.numShortcuts = 0;
+
+    // Edges between vertices that have not been contracted yet
+    vector<vector<HierarchyEdge>> working(numVertices);
+    for (int v = 0; v < numVertices; ++v) {
+        const vector<Neighbor> &neighbors = hierarchy.adjacency.neighbors[v];
+        for (int i = 0; i < (int) neighbors.size(); ++i) {
+            addOrShorten(working[v], neighbors[i].vertex, neighbors[i].length,
+                         -1);
+        }
+    }
+
+    WitnessSearch search(numVertices);
+    vector<int> contractedNeighbors(numVertices, 0);
+
+    // (priority, vertex), lowest priority on top
+    typedef pair<int, int> OrderEntry;
+    priority_queue<OrderEntry, vector<OrderEntry>, greater<OrderEntry>> order;
+    for (int v = 0; v < numVertices; ++v) {
+        order.push(OrderEntry(priority(working, v, contractedNeighbors, search,
+                                       loopCounter), v));
+    }
+
+    int nextRank = 0;
+    while (!order.empty()) {
+        int v = order.top().second;
+        order.pop();
+
+        // Lazy update: the priority may be stale now that neighbors have
+        // been contracted. Contract only if v is still the cheapest.
+        int current = priority(working, v, contractedNeighbors, search,
+                               loopCounter);
+        if (!order.empty() && current > order.top().first) {
+            order.push(OrderEntry(current, v));
+            continue;
+        }
+
+        hierarchy.numShortcuts +=
+            contractVertex(working, v, true, search, loopCounter);
+        hierarchy.rank[v] = nextRank++;
+
+        // All remaining neighbors are ranked higher than v
+        for (int i = 0; i < (int) working[v].size(); ++i) {
+            const HierarchyEdge &edge = working[v][i];
+            hierarchy.upward[v].push_back(edge);
+            hierarchy.downward[edge.vertex].push_back(
+                HierarchyEdge{v, edge.length, edge.middle});
+
+            // Remove v from the remaining graph
+            vector<HierarchyEdge> &other = working[edge.vertex];
+            for (int j = 0; j < (int) other.size(); ++j) {
+                if (other[j].vertex == v) {
+                    other[j] = other.back();
+                    other.pop_back();
+                    break;
+                }
+            }
+            ++contractedNeighbors[edge.vertex];
+        }
+        working[v].clear();
+    }
+}
+
+// EFFECTS : Returns the middle vertex of the hierarchy edge between a and b
+static int edgeMiddle(const ContractionHierarchy &hierarchy, int a, int b) {
+    // The edge is stored in the upward list of the lower ranked endpoint
+    int lower = a;
+    int higher = b;
+    if (hierarchy.rank[b] < hierarchy.rank[a]) {
+        lower = b;
+        higher = a;
+    }
+    const vector<HierarchyEdge> &edges = hierarchy.upward[lower];
+    for (int i = 0; i < (int) edges.size(); ++i) {
+        if (edges[i].vertex == higher) {
+            return edges[i].middle;
+        }
+    }
+    assert(false);
+    return -1;
+}
+
+// MODIFIES: path
+// EFFECTS : Appends the original-graph vertices of the hierarchy edge from a
+//           to b (with the given middle) to path, not including a
+static void unpackEdge(const ContractionHierarchy &hierarchy, int a, int b,
+                       int middle, vector<int> &path) {
+    if (middle == -1) {
+        path.push_back(b);
+        return;
+    }
+    unpackEdge(hierarchy, a, middle, edgeMiddle(hierarchy, a, middle), path);
+    unpackEdge(hierarchy, middle, b, edgeMiddle(hierarchy, middle, b), path);
+}
+
+// One direction of the bidirectional search
+struct UpwardSearch {
+    vector<double> distances;
+    // Vertex before each vertex on the search path (-1 if reached directly
+    // from the query point)
+    vector<int> previous;
+    // Middle of the hierarchy edge from previous
+    vector<int> previousMiddle;
+    MinQueue queue;
+};
+
+// MODIFIES: search
+// EFFECTS : Starts search from every vertex the query point can see
+static void initUpward(UpwardSearch &search, int numVertices,
+                       const vector<Neighbor> &seen) {
+    search.distances.assign(numVertices, INFINITE_DISTANCE);
+    search.previous.assign(numVertices, -1);
+    search.previousMiddle.assign(numVertices, -1);
+    for (int i = 0; i < (int) seen.size(); ++i) {
+        int v = seen[i].vertex;
+        if (seen[i].length < search.distances[v]) {
+            search.distances[v] = seen[i].length;
+            search.queue.push(QueueEntry(seen[i].length, v));
+        }
+    }
+}
+
+// MODIFIES: search, best, meeting, nodesSettled
+// EFFECTS : Settles vertices of search along upward edges until its smallest
+//           key is no better than best. Whenever a settled vertex has also
+//           been reached by other, updates best and meeting.
+static void runUpward(const ContractionHierarchy &hierarchy,
+                      UpwardSearch &search, const UpwardSearch &other,
+                      double &best, int &meeting, int &nodesSettled) {
+    while (!search.queue.empty()) {
+        QueueEntry top = search.queue.top();
+        search.queue.pop();
+        int u = top.second;
+        if (top.first > search.distances[u]) {
+            continue;
+        }
+        if (top.first >= best) {
+            break;
+        }
+        ++nodesSettled;
+
+        if (!other.distances.empty() &&
+            search.distances[u] + other.distances[u] < best) {
+            best = search.distances[u] + other.distances[u];
+            meeting = u;
+        }
+
+        const vector<HierarchyEdge> &edges = hierarchy.upward[u];
+        for (int i = 0; i < (int) edges.size(); ++i) {
+            int w = edges[i].vertex;
+            double newDistance = search.distances[u] + edges[i].length;
+            if (newDistance < search.distances[w]) {
+                search.distances[w] = newDistance;
+                search.previous[w] = u;
+                search.previousMiddle[w] = edges[i].middle;
+                search.queue.push(QueueEntry(newDistance, w));
+            }
+        }
+    }
+}
+
+// MODIFIES: path
+// EFFECTS : Appends the unpacked path from the first vertex search reached
+//           up to v to path (in order first vertex -> v)
+static void unpackSearchPath(const ContractionHierarchy &hierarchy,
+                             const UpwardSearch &search, int v,
+                             vector<int> &path) {
+    // Walk back to the first vertex, then unpack edges in forward order
+    vector<int> chain;
+    for (int u = v; u != -1; u = search.previous[u]) {
+        chain.push_back(u);
+    }
+    path.push_back(chain.back());
+    for (int i = (int) chain.size() - 1; i > 0; --i) {
+        unpackEdge(hierarchy, chain[i], chain[i - 1],
+                   search.previousMiddle[chain[i - 1]], path);
+    }
+}
+
+// REQUIRES: hierarchy was built from the graph start and goal were attached
+//           to, attachedEdges are the edges added when attaching them (see
+//           the victims overload of visibleVertices), solution is empty
+// MODIFIES: solution, nodesSettled
+// EFFECTS : Runs a bidirectional upward search from start and goal, then
+//           unpacks every shortcut on the best path. solution becomes the
+//           path from goal back to start (the same order AStarSearch uses, so
+//           it can be given to Problem::printSolution), or empty on failure.
+//           Adds the number of vertices settled to nodesSettled. Returns the
+//           path cost, or -1 on failure.
+double contractionSearch(const ContractionHierarchy &hierarchy,
+                         const List<Edge> &attachedEdges, State start,
+                         State goal, std::vector<State> &solution,
+                         int &nodesSettled) {
+    assert(solution.empty());
+    const int numVertices = (int) hierarchy.adjacency.vertices.size();
+
+    double best = INFINITE_DISTANCE;
+    int meeting = -1;
+
+    // Start and goal may see each other directly
+    List<Edge>::Iterator end = attachedEdges.end();
+    for (List<Edge>::Iterator e = attachedEdges.begin(); e != end; ++e) {
+        if (((*e)->v1 == start.position && (*e)->v2 == goal.position) ||
+            ((*e)->v1 == goal.position && (*e)->v2 == start.position)) {
+            best = (*e)->length;
+        }
+    }
+
+    vector<Neighbor> startSees;
+    vector<Neighbor> goalSees;
+    attachedNeighbors(hierarchy.adjacency, attachedEdges, start.position,
+                      startSees);
+    attachedNeighbors(hierarchy.adjacency, attachedEdges, goal.position,
+                      goalSees);
+
+    UpwardSearch forward;
+    UpwardSearch backward;
+    initUpward(forward, numVertices, startSees);
+    runUpward(hierarchy, forward, backward, best, meeting, nodesSettled);
+    initUpward(backward, numVertices, goalSees);
+    runUpward(hierarchy, backward, forward, best, meeting, nodesSettled);
+
+    if (best == INFINITE_DISTANCE) {
+        return -1;
+    }
+
+    solution.push_back(goal);
+    if (meeting != -1) {
+        // Vertices from start's side up to the meeting vertex, then from
+        // goal's side up to the meeting vertex
+        vector<int> startSide;
+        vector<int> goalSide;
+        unpackSearchPath(hierarchy, forward, meeting, startSide);
+        unpackSearchPath(hierarchy, backward, meeting, goalSide);
+
+        // solution runs goal -> start
+        for (int i = 0; i < (int) goalSide.size() - 1; ++i) {
+            solution.push_back(
+                State{hierarchy.adjacency.vertices[goalSide[i]]});
+        }
+        for (int i = (int) startSide.size() - 1; i >= 0; --i) {
+            solution.push_back(
+                State{hierarchy.adjacency.vertices[startSide[i]]});
+        }
+    }
+    solution.push_back(start);
+
+    return best;
+}
+
+// EFFECTS : Returns the length of path (a solution vector in either order)
+//           along the edges of graph, or -1 if two consecutive states of
+//           path are not joined by an edge of graph. An empty path has
+//           length -1 and a single state length 0.
+double graphPathLength(const Graph &graph, const vector<State> &path) {
+    if (path.empty()) {
+        return -1;
+    }
+    double length = 0;
+    for (int i = 0; i + 1 < (int) path.size(); ++i) {
+        // Find the edge between path[i] and path[i + 1], comparing
+        // coordinates as State does
+        const Vertex &a = *path[i].position;
+        const Vertex &b = *path[i + 1].position;
+        bool found = false;
+        List<Edge>::Iterator end = graph.connections.end();
+        for (List<Edge>::Iterator edge = graph.connections.begin();
+             edge != end; ++edge) {
+            if ((*(*edge)->v1 == a && *(*edge)->v2 == b) ||
+                (*(*edge)->v1 == b && *(*edge)->v2 == a)) {
+                length += (*edge)->length;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return -1;
+        }
+    }
+    return length;
+}
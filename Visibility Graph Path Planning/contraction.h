@@ -0,0 +1,78 @@
+//
+//  contraction.h
+//  Visibility Graph Path Planning
+//
+//  Contraction hierarchy over the polygon-vertex visibility graph. The
+//  obstacle graph does not change between searches, so its vertices are
+//  contracted once (least important first), adding shortcut edges wherever a
+//  contracted vertex was the only way to keep a shortest path. A query then
+//  only has to search upward (toward more important vertices) from both start
+//  and goal, which settles a small fraction of the graph.
+//
+
+#ifndef contraction_h
+#define contraction_h
+
+#include <vector>
+#include "preprocessing.h"
+#include "adjacency.h"
+#include "AStarState.h"
+
+// Edge of the hierarchy. middle is -1 for an edge of the original graph, or
+// the contracted vertex a shortcut replaces (the shortcut stands for the path
+// vertex -> middle -> other endpoint).
+struct HierarchyEdge {
+    int vertex;
+    double length;
+    int middle;
+};
+
+struct ContractionHierarchy {
+    // Indexed view of the graph the hierarchy was built from
+    AdjacencyGraph adjacency;
+    // Contraction order of each vertex (the vertex with rank 0 was
+    // contracted first)
+    std::vector<int> rank;
+    // upward[v] holds the edges from v to higher ranked vertices
+    std::vector<std::vector<HierarchyEdge>> upward;
+    // downward[v] holds the edges from v to lower ranked vertices
+    std::vector<std::vector<HierarchyEdge>> downward;
+    // Number of shortcut edges added during contraction
+    int numShortcuts;
+};
+
+// REQUIRES: graph has been pre-processed (does not contain start and goal),
+//           hierarchy is empty
+// MODIFIES: hierarchy, loopCounter
+// EFFECTS : Orders the vertices of graph by edge difference (shortcuts added
+//           minus edges removed, updated lazily) and contracts them in that
+//           order, adding a shortcut between two neighbors of a contracted
+//           vertex whenever a bounded witness search finds no path that is at
+//           least as short. Adds the number of vertices settled by witness
+//           searches to loopCounter.
+void buildContractionHierarchy(const Graph &graph,
+                               ContractionHierarchy &hierarchy,
+                               int &loopCounter);
+
+// REQUIRES: hierarchy was built from the graph start and goal were attached
+//           to, attachedEdges are the edges added when attaching them (see
+//           the victims overload of visibleVertices), solution is empty
+// MODIFIES: solution, nodesSettled
+// EFFECTS : Runs a bidirectional upward search from start and goal, then
+//           unpacks every shortcut on the best path. solution becomes the
+//           path from goal back to start (the same order AStarSearch uses, so
+//           it can be given to Problem::printSolution), or empty on failure.
+//           Adds the number of vertices settled to nodesSettled. Returns the
+//           path cost, or -1 on failure.
+double contractionSearch(const ContractionHierarchy &hierarchy,
+                         const List<Edge> &attachedEdges, State start,
+                         State goal, std::vector<State> &solution,
+                         int &nodesSettled);
+
+// EFFECTS : Returns the length of path (a solution vector in either order)
+//           along the edges of graph, or -1 if two consecutive states of
+//           path are not joined by an edge of graph. An empty path has
+//           length -1 and a single state length 0.
+double graphPathLength(const Graph &graph, const std::vector<State> &path);
+
+#endif /* contraction_h */
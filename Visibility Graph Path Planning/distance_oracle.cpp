@@ -0,0 +1,176 @@
+//
+//  distance_oracle.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <limits>
+#include "distance_oracle.h"
+#include "search_functions.h"
+
+using namespace std;
+
+// Constructs an empty oracle that has not been built
+DistanceOracle::DistanceOracle() :
+built(false) {}
+
+// EFFECTS : Returns the number of bytes the tables need for numVertices
+//           vertices
+size_t oracleMemory(int numVertices) {
+    return (size_t) numVertices * (size_t) numVertices *
+           (sizeof(double) + sizeof(int));
+}
+
+// REQUIRES: graph has been pre-processed (does not contain start and goal),
+//           oracle is empty
+// MODIFIES: oracle, loopCounter
+// EFFECTS : If the tables for graph fit in maxBytes, runs Dijkstra from every
+//           vertex to fill them and sets oracle.built. Otherwise leaves the
+//           tables empty. Adds the number of vertices settled to loopCounter.
+//           Returns oracle.built.
+bool buildDistanceOracle(const Graph &graph, size_t maxBytes,
+                         DistanceOracle &oracle, int &loopCounter) {
+    assert(oracle.distances.empty());
+
+    oracle.built = false;
+    const int numVertices = graph.vertices.size();
+    if (oracleMemory(numVertices) > maxBytes) {
+        return false;
+    }
+
+    buildAdjacency(graph, oracle.adjacency);
+    oracle.distances.resize((size_t) numVertices * numVertices);
+    oracle.nextHop.resize((size_t) numVertices * numVertices);
+
+    vector<double> fromTarget;
+    vector<int> previous;
+    for (int target = 0; target < numVertices; ++target) {
+        shortestPaths(oracle.adjacency, target, fromTarget, previous,
+                      loopCounter);
+
+        // The vertex before i on a path from target is the vertex after i on
+        // the same path walked from i to target
+        for (int i = 0; i < numVertices; ++i) {
+            size_t entry = (size_t) i * numVertices + target;
+            oracle.distances[entry] = fromTarget[i];
+            oracle.nextHop[entry] = previous[i];
+        }
+    }
+
+    oracle.built = true;
+    return true;
+}
+
+// REQUIRES: oracle.built, oracle was built from the graph start and goal were
+//           attached to, attachedEdges are the edges added when attaching
+//           them (see the victims overload of visibleVertices), solution is
+//           empty
+// MODIFIES: solution
+// EFFECTS : Answers the query with a min-plus product over the vertices
+//           start and goal can see, then follows the next-hop table.
+//           solution becomes the path from goal back to start (the order
+//           AStarSearch uses), or empty on failure. Returns the path cost,
+//           or -1 on failure.
+double oracleSearch(const DistanceOracle &oracle,
+                    const List<Edge> &attachedEdges, State start, State goal,
+                    std::vector<State> &solution) {
+    assert(oracle.built);
+    assert(solution.empty());
+
+    const double infinity = numeric_limits<double>::infinity();
+    const size_t numVertices = oracle.adjacency.vertices.size();
+
+    // Start and goal may see each other directly
+    double best = infinity;
+    int bestStart = -1;
+    int bestGoal = -1;
+    List<Edge>::Iterator end = attachedEdges.end();
+    for (List<Edge>::Iterator e = attachedEdges.begin(); e != end; ++e) {
+        if (((*e)->v1 == start.position && (*e)->v2 == goal.position) ||
+            ((*e)->v1 == goal.position && (*e)->v2 == start.position)) {
+            best = (*e)->length;
+        }
+    }
+
+    vector<Neighbor> startSees;
+    vector<Neighbor> goalSees;
+    attachedNeighbors(oracle.adjacency, attachedEdges, start.position,
+                      startSees);
+    attachedNeighbors(oracle.adjacency, attachedEdges, goal.position,
+                      goalSees);
+
+    // Split start's side into flat arrays so the inner loop is a plain
+    // gather, add and min
+    const int numStart = (int) startSees.size();
+    vector<int> startIndex(numStart);
+    vector<double> startCost(numStart);
+    for (int k = 0; k < numStart; ++k) {
+        startIndex[k] = startSees[k].vertex;
+        startCost[k] = startSees[k].length;
+    }
+    vector<double> sums(numStart);
+
+    // Min-plus product: the table is symmetric, so row g holds d(s, g) for
+    // every s
+    for (int j = 0; j < (int) goalSees.size(); ++j) {
+        const double *row =
+            &oracle.distances[goalSees[j].vertex * numVertices];
+        const double goalCost = goalSees[j].length;
+
+        double rowBest = infinity;
+        for (int k = 0; k < numStart; ++k) {
+            sums[k] = startCost[k] + row[startIndex[k]];
+            rowBest = sums[k] < rowBest ? sums[k] : rowBest;
+        }
+
+        if (rowBest + goalCost < best) {
+            best = rowBest + goalCost;
+            bestGoal = goalSees[j].vertex;
+            for (int k = 0; k < numStart; ++k) {
+                if (sums[k] == rowBest) {
+                    bestStart = startIndex[k];
+                    break;
+                }
+            }
+        }
+    }
+
+    if (best == infinity) {
+        return -1;
+    }
+
+    // Walk start -> goal through the next-hop table, then store it in
+    // reverse like findSoln does
+    vector<const Vertex*> path;
+    path.push_back(start.position);
+    if (bestStart != -1) {
+        for (int v = bestStart; v != -1;
+             v = oracle.nextHop[v * numVertices + bestGoal]) {
+            path.push_back(oracle.adjacency.vertices[v]);
+        }
+    }
+    path.push_back(goal.position);
+
+    for (int i = (int) path.size() - 1; i >= 0; --i) {
+        solution.push_back(State{path[i]});
+    }
+    return best;
+}
+
+// REQUIRES: p searches the graph start and goal were attached to. The rest is
+//           the same as oracleSearch and AStarSearch (oracle need not be
+//           built).
+// MODIFIES: solution, nodesExpanded, maxTreeSize, memoryUse
+// EFFECTS : Uses oracleSearch if oracle was built, AStarSearch on p
+//           otherwise. nodesExpanded, maxTreeSize and memoryUse are only
+//           changed by AStarSearch. Returns the path cost, or -1 on failure.
+double oracleOrAStarSearch(const DistanceOracle &oracle, const Problem &p,
+                           const List<Edge> &attachedEdges, State start,
+                           State goal, std::vector<State> &solution,
+                           int &nodesExpanded, int &maxTreeSize,
+                           size_t &memoryUse) {
+    if (oracle.built) {
+        return oracleSearch(oracle, attachedEdges, start, goal, solution);
+    }
+    return AStarSearch(p, solution, nodesExpanded, maxTreeSize, memoryUse);
+}
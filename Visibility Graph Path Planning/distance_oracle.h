@@ -0,0 +1,79 @@
+//
+//  distance_oracle.h
+//  Visibility Graph Path Planning
+//
+//  All-pairs shortest distances between polygon vertices, with next-hop
+//  tables for path recovery. Once start sees the set of vertices S and goal
+//  sees G, the answer is the minimum over s in S, g in G of
+//  |start - s| + d(s, g) + |g - goal|, so a query needs no search at all.
+//  The tables grow with the square of the vertex count, so they are only
+//  built below a memory ceiling; otherwise queries fall back to AStarSearch.
+//
+
+#ifndef distance_oracle_h
+#define distance_oracle_h
+
+#include <vector>
+#include "preprocessing.h"
+#include "adjacency.h"
+#include "AStarProblem.h"
+
+struct DistanceOracle {
+    // Indexed view of the graph the tables were built from
+    AdjacencyGraph adjacency;
+    // distances[i * n + j] is the shortest distance between vertices i and j
+    // (n = number of vertices, infinity if unreachable)
+    std::vector<double> distances;
+    // nextHop[i * n + j] is the vertex after i on a shortest path from i to j
+    // (-1 if i == j or j is unreachable)
+    std::vector<int> nextHop;
+    // False until the tables are built (stays false if they did not fit
+    // under the memory ceiling)
+    bool built;
+
+    // Constructs an empty oracle that has not been built
+    DistanceOracle();
+};
+
+// EFFECTS : Returns the number of bytes the tables need for numVertices
+//           vertices
+size_t oracleMemory(int numVertices);
+
+// REQUIRES: graph has been pre-processed (does not contain start and goal),
+//           oracle is empty
+// MODIFIES: oracle, loopCounter
+// EFFECTS : If the tables for graph fit in maxBytes, runs Dijkstra from every
+//           vertex to fill them and sets oracle.built. Otherwise leaves the
+//           tables empty. Adds the number of vertices settled to loopCounter.
+//           Returns oracle.built.
+bool buildDistanceOracle(const Graph &graph, size_t maxBytes,
+                         DistanceOracle &oracle, int &loopCounter);
+
+// REQUIRES: oracle.built, oracle was built from the graph start and goal were
+//           attached to, attachedEdges are the edges added when attaching
+//           them (see the victims overload of visibleVertices), solution is
+//           empty
+// MODIFIES: solution
+// EFFECTS : Answers the query with a min-plus product over the vertices
+//           start and goal can see, then follows the next-hop table.
+//           solution becomes the path from goal back to start (the order
+//           AStarSearch uses), or empty on failure. Returns the path cost,
+//           or -1 on failure.
+double oracleSearch(const DistanceOracle &oracle,
+                    const List<Edge> &attachedEdges, State start, State goal,
+                    std::vector<State> &solution);
+
+// REQUIRES: p searches the graph start and goal were attached to. The rest is
+//           the same as oracleSearch and AStarSearch (oracle need not be
+//           built).
+// MODIFIES: solution, nodesExpanded, maxTreeSize, memoryUse
+// EFFECTS : Uses oracleSearch if oracle was built, AStarSearch on p
+//           otherwise. nodesExpanded, maxTreeSize and memoryUse are only
+//           changed by AStarSearch. Returns the path cost, or -1 on failure.
+double oracleOrAStarSearch(const DistanceOracle &oracle, const Problem &p,
+                           const List<Edge> &attachedEdges, State start,
+                           State goal, std::vector<State> &solution,
+                           int &nodesExpanded, int &maxTreeSize,
+                           size_t &memoryUse);
+
+#endif /* distance_oracle_h */
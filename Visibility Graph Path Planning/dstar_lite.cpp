@@ -0,0 +1,353 @@
+//
+//  dstar_lite.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <limits>
+#include <map>
+#include <algorithm>
+#include "dstar_lite.h"
+
+using namespace std;
+
+static const double INFINITE_COST = numeric_limits<double>::infinity();
+
+// MODIFIES: snapshot
+// EFFECTS : Records the vertices and edges of graph in snapshot
+void recordEdges(const Graph &graph, GraphEdges &snapshot) {
+    snapshot.vertices.clear();
+    snapshot.edges.clear();
+    
+    List<Vertex>::Iterator endV = graph.vertices.end();
+    for (List<Vertex>::Iterator v = graph.vertices.begin(); v != endV; ++v) {
+        snapshot.vertices.push_back(*v);
+    }
+    List<Edge>::Iterator endE = graph.connections.end();
+    for (List<Edge>::Iterator e = graph.connections.begin(); e != endE; ++e) {
+        snapshot.edges.push_back(**e);
+    }
+}
+
+// Endpoints of an edge in a fixed order, so both directions match
+typedef pair<const Vertex*, const Vertex*> EdgeEnds;
+
+// EFFECTS : Returns the endpoints of e, smaller address first
+static EdgeEnds edgeEnds(const Edge &e) {
+    return less<const Vertex*>()(e.v1, e.v2) ? EdgeEnds(e.v1, e.v2)
+                                              : EdgeEnds(e.v2, e.v1);
+}
+
+// REQUIRES: before was recorded from graph, and the update since then did not
+//           both delete vertices and create new ones (a new vertex could
+//           reuse a deleted vertex's address)
+// MODIFIES: changes, removedVertices
+// EFFECTS : Sets changes to the edges that were removed (with length set to
+//           infinity) or added since before was recorded, and
+//           removedVertices to the vertices that are no longer in graph
+//           (these pointers must not be dereferenced).
+void diffEdges(const GraphEdges &before, const Graph &graph,
+               std::vector<Edge> &changes,
+               std::vector<const Vertex*> &removedVertices) {
+    changes.clear();
+    removedVertices.clear();
+    
+    GraphEdges after;
+    recordEdges(graph, after);
+    
+    // Edges of before that are still present are marked true
+    map<EdgeEnds, bool> oldEdges;
+    for (int i = 0; i < (int) before.edges.size(); ++i) {
+        oldEdges[edgeEnds(before.edges[i])] = false;
+    }
+    for (int i = 0; i < (int) after.edges.size(); ++i) {
+        map<EdgeEnds, bool>::iterator found =
+            oldEdges.find(edgeEnds(after.edges[i]));
+        if (found == oldEdges.end()) {
+            changes.push_back(after.edges[i]);
+        } else {
+            found->second = true;
+        }
+    }
+    for (int i = 0; i < (int) before.edges.size(); ++i) {
+        if (!oldEdges[edgeEnds(before.edges[i])]) {
+            Edge removed = before.edges[i];
+            removed.length = INFINITE_COST;
+            changes.push_back(removed);
+        }
+    }
+    
+    vector<const Vertex*> remaining = after.vertices;
+    sort(remaining.begin(), remaining.end());
+    for (int i = 0; i < (int) before.vertices.size(); ++i) {
+        if (!binary_search(remaining.begin(), remaining.end(),
+                           before.vertices[i])) {
+            removedVertices.push_back(before.vertices[i]);
+        }
+    }
+}
+
+// REQUIRES: startState and goalState have been attached to graph (see
+//           visibleVertices)
+// EFFECTS : Builds the planner from the edges of graph. Nothing is
+//           searched until plan is called.
+DStarLite::DStarLite(const Graph &graph, State startState, State goalState) :
+start(-1), goal(-1), km(0) {
+    List<Vertex>::Iterator endV = graph.vertices.end();
+    for (List<Vertex>::Iterator v = graph.vertices.begin(); v != endV; ++v) {
+        vertexNumber(*v);
+    }
+    List<Edge>::Iterator endE = graph.connections.end();
+    for (List<Edge>::Iterator e = graph.connections.begin(); e != endE; ++e) {
+        setCost(vertexNumber((*e)->v1), vertexNumber((*e)->v2),
+                (*e)->length);
+    }
+    
+    start = vertexNumber(startState.position);
+    goal = vertexNumber(goalState.position);
+    
+    // The search grows backward from the goal
+    rhs[goal] = 0;
+    updateVertex(goal);
+}
+
+// EFFECTS : Returns the index of v, numbering it first if it is new
+int DStarLite::vertexNumber(const Vertex *v) {
+    unordered_map<const Vertex*, int>::iterator found = index.find(v);
+    if (found != index.end()) {
+        return found->second;
+    }
+    
+    int number = (int) vertices.size();
+    index[v] = number;
+    vertices.push_back(v);
+    coordinates.push_back(*v);
+    links.push_back(vector<Link>());
+    g.push_back(INFINITE_COST);
+    rhs.push_back(INFINITE_COST);
+    queuedKey.push_back(Key(INFINITE_COST, INFINITE_COST));
+    inQueue.push_back(false);
+    return number;
+}
+
+// EFFECTS : Returns the straight-line distance between vertices a and b
+double DStarLite::heuristic(int a, int b) const {
+    return distanceFormula(coordinates[a], coordinates[b]);
+}
+
+// EFFECTS : Returns the queue key of vertex u
+DStarLite::Key DStarLite::calculateKey(int u) const {
+    double best = min(g[u], rhs[u]);
+    return Key(best + heuristic(start, u) + km, best);
+}
+
+// MODIFIES: this
+// EFFECTS : Recomputes rhs of u (unless u is the goal) from its neighbors
+void DStarLite::updateRhs(int u) {
+    if (u == goal) {
+        return;
+    }
+    double best = INFINITE_COST;
+    for (int i = 0; i < (int) links[u].size(); ++i) {
+        best = min(best, links[u][i].cost + g[links[u][i].vertex]);
+    }
+    rhs[u] = best;
+}
+
+// MODIFIES: this
+// EFFECTS : Queues u if it is inconsistent (g != rhs), removes it from
+//           the queue otherwise
+void DStarLite::updateVertex(int u) {
+    if (inQueue[u]) {
+        queue.erase(QueueEntry(queuedKey[u], u));
+        inQueue[u] = false;
+    }
+    if (g[u] != rhs[u]) {
+        queuedKey[u] = calculateKey(u);
+        queue.insert(QueueEntry(queuedKey[u], u));
+        inQueue[u] = true;
+    }
+}
+
+// MODIFIES: this
+// EFFECTS : Sets the cost of the edge between u and v in both directions,
+//           adding it if it is new and removing it if cost is infinity
+void DStarLite::setCost(int u, int v, double cost) {
+    for (int side = 0; side < 2; ++side) {
+        vector<Link> &uLinks = links[u];
+        int found = -1;
+        for (int i = 0; i < (int) uLinks.size(); ++i) {
+            if (uLinks[i].vertex == v) {
+                found = i;
+                break;
+            }
+        }
+        
+        if (cost == INFINITE_COST) {
+            if (found != -1) {
+                uLinks[found] = uLinks.back();
+                uLinks.pop_back();
+            }
+        } else if (found != -1) {
+            uLinks[found].cost = cost;
+        } else {
+            uLinks.push_back(Link{v, cost});
+        }
+        swap(u, v);
+    }
+}
+
+// MODIFIES: this, nodesExpanded
+// EFFECTS : Expands vertices until start is consistent and no queued key
+//           is smaller than start's. Adds the number of expansions to
+//           nodesExpanded.
+void DStarLite::computeShortestPath(int &nodesExpanded) {
+    while (!queue.empty() &&
+           (queue.begin()->first < calculateKey(start) ||
+            rhs[start] > g[start])) {
+        Key oldKey = queue.begin()->first;
+        int u = queue.begin()->second;
+        Key newKey = calculateKey(u);
+        
+        if (oldKey < newKey) {
+            // Queued before the start moved, requeue with the current key
+            updateVertex(u);
+            continue;
+        }
+        
+        ++nodesExpanded;
+        
+        if (g[u] > rhs[u]) {
+            // Overconsistent: u's distance went down, pass it on
+            g[u] = rhs[u];
+            updateVertex(u);
+            for (int i = 0; i < (int) links[u].size(); ++i) {
+                int s = links[u][i].vertex;
+                if (s != goal) {
+                    rhs[s] = min(rhs[s], links[u][i].cost + g[u]);
+                }
+                updateVertex(s);
+            }
+        } else {
+            // Underconsistent: u's distance went up, every neighbor that
+            // relied on it has to look again
+            double oldG = g[u];
+            g[u] = INFINITE_COST;
+            updateRhs(u);
+            updateVertex(u);
+            for (int i = 0; i < (int) links[u].size(); ++i) {
+                int s = links[u][i].vertex;
+                if (rhs[s] == links[u][i].cost + oldG) {
+                    updateRhs(s);
+                }
+                updateVertex(s);
+            }
+        }
+    }
+}
+
+// REQUIRES: startState is a vertex of the graph, either already known to
+//           the planner or given edges by the next updateEdges call
+// MODIFIES: this
+// EFFECTS : Moves the start (the vehicle) to startState
+void DStarLite::moveStart(State startState) {
+    int newStart = vertexNumber(startState.position);
+    km += heuristic(start, newStart);
+    start = newStart;
+}
+
+// REQUIRES: every edge in changes is a new edge, or an existing edge with
+//           its new length (infinity if it was removed). Every edge of
+//           each vertex in removedVertices is in changes as removed.
+// MODIFIES: this
+// EFFECTS : Applies the changes and forgets the removed vertices. Only the
+//           endpoints of the changed edges are queued for repair.
+void DStarLite::updateEdges(const std::vector<Edge> &changes,
+                            const std::vector<const Vertex*> &removedVertices) {
+    for (int i = 0; i < (int) changes.size(); ++i) {
+        int u = vertexNumber(changes[i].v1);
+        int v = vertexNumber(changes[i].v2);
+        double newCost = changes[i].length;
+        
+        double oldCost = INFINITE_COST;
+        for (int j = 0; j < (int) links[u].size(); ++j) {
+            if (links[u][j].vertex == v) {
+                oldCost = links[u][j].cost;
+                break;
+            }
+        }
+        setCost(u, v, newCost);
+        
+        // Same repair in both directions
+        for (int side = 0; side < 2; ++side) {
+            if (u != goal) {
+                if (oldCost > newCost) {
+                    rhs[u] = min(rhs[u], newCost + g[v]);
+                } else if (rhs[u] == oldCost + g[v]) {
+                    updateRhs(u);
+                }
+            }
+            updateVertex(u);
+            swap(u, v);
+        }
+    }
+    
+    for (int i = 0; i < (int) removedVertices.size(); ++i) {
+        unordered_map<const Vertex*, int>::iterator found =
+            index.find(removedVertices[i]);
+        if (found != index.end()) {
+            // The start and goal must stay in the graph
+            assert(found->second != start && found->second != goal);
+            vertices[found->second] = nullptr;
+            index.erase(found);
+        }
+    }
+}
+
+// REQUIRES: solution is empty
+// MODIFIES: this, solution, nodesExpanded
+// EFFECTS : Repairs the search and sets solution to the path from goal
+//           back to start (the order AStarSearch uses), or leaves it
+//           empty if goal cannot be reached. Adds the number of expansions
+//           to nodesExpanded. Returns the path cost, or -1 on failure.
+double DStarLite::plan(std::vector<State> &solution, int &nodesExpanded) {
+    assert(solution.empty());
+    
+    computeShortestPath(nodesExpanded);
+    if (rhs[start] == INFINITE_COST) {
+        return -1;
+    }
+    
+    // Walk downhill in cost + g from start; a path can't visit more vertices
+    // than there are
+    vector<const Vertex*> path;
+    double cost = 0;
+    int current = start;
+    path.push_back(vertices[start]);
+    while (current != goal) {
+        if (path.size() > vertices.size()) {
+            return -1;
+        }
+        int next = -1;
+        double best = INFINITE_COST;
+        for (int i = 0; i < (int) links[current].size(); ++i) {
+            double through = links[current][i].cost +
+                             g[links[current][i].vertex];
+            if (through < best) {
+                best = through;
+                next = i;
+            }
+        }
+        if (next == -1) {
+            return -1;
+        }
+        cost += links[current][next].cost;
+        current = links[current][next].vertex;
+        path.push_back(vertices[current]);
+    }
+    
+    for (int i = (int) path.size() - 1; i >= 0; --i) {
+        solution.push_back(State{path[i]});
+    }
+    return cost;
+}
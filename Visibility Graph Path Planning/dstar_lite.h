@@ -0,0 +1,142 @@
+//
+//  dstar_lite.h
+//  Visibility Graph Path Planning
+//
+//  D* Lite incremental replanning. The search runs backward from the goal and
+//  keeps its g and rhs values between calls, so after the map changes (edges
+//  removed or added by an obstacle update) or the vehicle moves, only the
+//  vertices whose distance to the goal actually changed are expanded again.
+//  Keys are offset by km, the total heuristic distance the start has moved,
+//  so the queue does not have to be reordered when the start moves.
+//
+
+#ifndef dstar_lite_h
+#define dstar_lite_h
+
+#include <vector>
+#include <set>
+#include <utility>
+#include <unordered_map>
+#include "preprocessing.h"
+#include "AStarState.h"
+
+// Edges and vertices of a graph at one point in time, used to find the edge
+// changes an update made (see diffEdges)
+struct GraphEdges {
+    std::vector<const Vertex*> vertices;
+    std::vector<Edge> edges;
+};
+
+// MODIFIES: snapshot
+// EFFECTS : Records the vertices and edges of graph in snapshot
+void recordEdges(const Graph &graph, GraphEdges &snapshot);
+
+// REQUIRES: before was recorded from graph, and the update since then did not
+//           both delete vertices and create new ones (a new vertex could
+//           reuse a deleted vertex's address)
+// MODIFIES: changes, removedVertices
+// EFFECTS : Sets changes to the edges that were removed (with length set to
+//           infinity) or added since before was recorded, and
+//           removedVertices to the vertices that are no longer in graph
+//           (these pointers must not be dereferenced).
+void diffEdges(const GraphEdges &before, const Graph &graph,
+               std::vector<Edge> &changes,
+               std::vector<const Vertex*> &removedVertices);
+
+class DStarLite {
+private:
+    // Queue keys, compared lexicographically
+    typedef std::pair<double, double> Key;
+    typedef std::pair<Key, int> QueueEntry;
+    
+    // Neighbor of a vertex and the cost of the edge to it
+    struct Link {
+        int vertex;
+        double cost;
+    };
+    
+    // Vertices are numbered in the order they are first seen. Coordinates
+    // are copied so that a vertex deleted from the graph can still be given
+    // a key until it leaves the queue.
+    std::vector<const Vertex*> vertices;
+    std::vector<Vertex> coordinates;
+    std::vector<std::vector<Link>> links;
+    std::unordered_map<const Vertex*, int> index;
+    
+    // g is the distance to the goal found by the last expansion, rhs the
+    // one-step lookahead min over neighbors of cost + g
+    std::vector<double> g;
+    std::vector<double> rhs;
+    
+    // Open vertices, and the key each is queued under (inQueue says whether
+    // queuedKey is valid)
+    std::set<QueueEntry> queue;
+    std::vector<Key> queuedKey;
+    std::vector<bool> inQueue;
+    
+    int start;
+    int goal;
+    // Heuristic distance the start has moved since the first plan
+    double km;
+    
+    // EFFECTS : Returns the index of v, numbering it first if it is new
+    int vertexNumber(const Vertex *v);
+    
+    // EFFECTS : Returns the straight-line distance between vertices a and b
+    double heuristic(int a, int b) const;
+    
+    // EFFECTS : Returns the queue key of vertex u
+    Key calculateKey(int u) const;
+    
+    // MODIFIES: this
+    // EFFECTS : Recomputes rhs of u (unless u is the goal) from its neighbors
+    void updateRhs(int u);
+    
+    // MODIFIES: this
+    // EFFECTS : Queues u if it is inconsistent (g != rhs), removes it from
+    //           the queue otherwise
+    void updateVertex(int u);
+    
+    // MODIFIES: this
+    // EFFECTS : Sets the cost of the edge between u and v in both directions,
+    //           adding it if it is new and removing it if cost is infinity
+    void setCost(int u, int v, double cost);
+    
+    // MODIFIES: this, nodesExpanded
+    // EFFECTS : Expands vertices until start is consistent and no queued key
+    //           is smaller than start's. Adds the number of expansions to
+    //           nodesExpanded.
+    void computeShortestPath(int &nodesExpanded);
+    
+public:
+    // REQUIRES: startState and goalState have been attached to graph (see
+    //           visibleVertices)
+    // EFFECTS : Builds the planner from the edges of graph. Nothing is
+    //           searched until plan is called.
+    DStarLite(const Graph &graph, State startState, State goalState);
+    
+    // REQUIRES: startState is a vertex of the graph, either already known to
+    //           the planner or given edges by the next updateEdges call
+    // MODIFIES: this
+    // EFFECTS : Moves the start (the vehicle) to startState
+    void moveStart(State startState);
+    
+    // REQUIRES: every edge in changes is a new edge, or an existing edge with
+    //           its new length (infinity if it was removed). Every edge of
+    //           each vertex in removedVertices is in changes as removed.
+    // MODIFIES: this
+    // EFFECTS : Applies the changes and forgets the removed vertices. Only the
+    //           endpoints of the changed edges are queued for repair.
+    void updateEdges(const std::vector<Edge> &changes,
+                     const std::vector<const Vertex*> &removedVertices);
+    
+    // REQUIRES: solution is empty
+    // MODIFIES: this, solution, nodesExpanded
+    // EFFECTS : Repairs the search and sets solution to the path from goal
+    //           back to start (the order AStarSearch uses), or leaves it
+    //           empty if goal cannot be reached. Adds the number of expansions
+    //           to nodesExpanded. Returns the path cost, or -1 on failure.
+    double plan(std::vector<State> &solution, int &nodesExpanded);
+};
+
+#endif /* dstar_lite_h */
@@ -0,0 +1,96 @@
+//
+//  geometry.h
+//  Visibility Graph Path Planning
+//
+//  Vertex type and the geometric kernels that run in the inner loops of
+//  preprocessing and search, specialized on the number of dimensions at
+//  compile time. The per-coordinate loops are unrolled by template recursion,
+//  so with two dimensions a distance is two subtractions, two multiplies, an
+//  add and a square root.
+//
+
+#ifndef geometry_h
+#define geometry_h
+
+#include <cmath>
+
+// Contains coordinates. This is a plain aggregate, so it can be copied with
+// memcpy and brace initialized.
+template <int D>
+struct BasicVertex {
+    double coord[D];
+    // Which polygon the Vertex is a member of (-1 if not part of a polygon)
+    int polygon;
+    // Which index within that polygon Vertex is (-1 if not part of a polygon)
+    int location;
+    // How many vertices the polygon that Vertex is part of contains (-1 if not
+    // part of a polygon)
+    int poly_size;
+};
+
+// EFFECTS : Returns x * x
+constexpr double square(double x) {
+    return x * x;
+}
+
+// Kernels over the first D coordinates of two coordinate arrays
+template <int D>
+struct CoordinateKernels {
+    // EFFECTS : Returns the sum of the squared coordinate differences
+    static constexpr double squaredDistance(const double *a, const double *b) {
+        return CoordinateKernels<D - 1>::squaredDistance(a, b) +
+               square(a[D - 1] - b[D - 1]);
+    }
+
+    // EFFECTS : Returns true if every coordinate is equal
+    static constexpr bool equal(const double *a, const double *b) {
+        return CoordinateKernels<D - 1>::equal(a, b) && a[D - 1] == b[D - 1];
+    }
+};
+
+// Recursion ends with no coordinates left
+template <>
+struct CoordinateKernels<0> {
+    static constexpr double squaredDistance(const double *, const double *) {
+        return 0;
+    }
+
+    static constexpr bool equal(const double *, const double *) {
+        return true;
+    }
+};
+
+// EFFECTS : Returns the squared distance between v1 and v2 (cheaper than
+//           distanceFormula when only comparing distances)
+template <int D>
+inline double squaredDistance(const BasicVertex<D> &v1,
+                              const BasicVertex<D> &v2) {
+    return CoordinateKernels<D>::squaredDistance(v1.coord, v2.coord);
+}
+
+// EFFECTS : returns the distance between v1 and v2
+template <int D>
+inline double distanceFormula(const BasicVertex<D> &v1,
+                              const BasicVertex<D> &v2) {
+    return std::sqrt(squaredDistance(v1, v2));
+}
+
+// EFFECTS : Returns true if lhs and rhs have exactly the same coordinates.
+template <int D>
+inline bool operator==(const BasicVertex<D> &lhs, const BasicVertex<D> &rhs) {
+    return CoordinateKernels<D>::equal(lhs.coord, rhs.coord);
+}
+
+// MODIFIES: left, right
+// EFFECTS : Sets left and right to the two products of the orientation
+//           formula (y2 - y1)*(x3 - x2) - (y3 - y2)*(x2 - x1), rounded
+//           (see orientation in preprocessing.cpp)
+inline void orientationProducts(const BasicVertex<2> &p1,
+                                const BasicVertex<2> &p2,
+                                const BasicVertex<2> &p3, double &left,
+                                double &right) {
+    left = (p2.coord[1] - p1.coord[1]) * (p3.coord[0] - p2.coord[0]);
+    right = (p3.coord[1] - p2.coord[1]) * (p2.coord[0] - p1.coord[0]);
+}
+
+#endif /* geometry_h */
@@ -0,0 +1,267 @@
+//
+//  incremental.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <array>
+#include <algorithm>
+#include "incremental.h"
+
+using namespace std;
+
+// Axis-aligned box around a polygon
+struct BoundingBox {
+    double low[DIMENSIONS];
+    double high[DIMENSIONS];
+};
+
+// Boxes that are closer than this are tested exactly (the orientation test in
+// intersect allows a tiny tolerance, so a box test that is too strict could
+// skip a segment a full rebuild would reject)
+static const double BOX_MARGIN = 1e-6;
+
+// REQUIRES: polygon is not empty
+// EFFECTS : Returns the bounding box of polygon
+static BoundingBox polygonBox(const List<Vertex> &polygon) {
+    BoundingBox box;
+    List<Vertex>::Iterator v = polygon.begin();
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        box.low[i] = box.high[i] = (*v)->coord[i];
+    }
+    List<Vertex>::Iterator end = polygon.end();
+    for (; v != end; ++v) {
+        for (int i = 0; i < DIMENSIONS; ++i) {
+            box.low[i] = min(box.low[i], (*v)->coord[i]);
+            box.high[i] = max(box.high[i], (*v)->coord[i]);
+        }
+    }
+    return box;
+}
+
+// EFFECTS : Returns false if segment [a, b] is clearly outside box
+static bool mayCross(const Vertex &a, const Vertex &b,
+                     const BoundingBox &box) {
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        if (max(a.coord[i], b.coord[i]) < box.low[i] - BOX_MARGIN ||
+            min(a.coord[i], b.coord[i]) > box.high[i] + BOX_MARGIN) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// REQUIRES: polygon contains at least 3 vertices
+// MODIFIES: loopCounter
+// EFFECTS : Returns true if segment [a, b] intersects an edge of polygon (the
+//           same test visible applies to every polygon). Adds the number of
+//           edges tested to loopCounter.
+static bool crossesPolygon(const Vertex &a, const Vertex &b,
+                           const List<Vertex> &polygon, int &loopCounter) {
+    List<Vertex>::Iterator begin = polygon.begin();
+    List<Vertex>::Iterator v1 = begin;
+    for (int j = 0; j < polygon.size(); ++j) {
+        List<Vertex>::Iterator v2 = v1;
+        v2.circularIncrement(begin);
+        
+        ++loopCounter;
+        
+        if (intersect(a, b, **v1, **v2)) {
+            return true;
+        }
+        v1 = v2;
+    }
+    return false;
+}
+
+// REQUIRES: graph was built from polygons by preProcess (possibly followed by
+//           other calls to addPolygon and removePolygon, and by attaching
+//           start and goal), polygon is a convex polygon of at least 3
+//           vertices that does not overlap, touch, or contain any polygon in
+//           polygons or any vertex of graph
+// MODIFIES: graph, polygons, polygon, visibleCounter
+// EFFECTS : Gives polygon an unused polygon index and appends it to polygons
+//           (which takes ownership). Removes the edges of graph that cross
+//           polygon's boundary, then adds polygon's vertices and every edge
+//           they have to the other vertices. Adds the number of segment tests
+//           to visibleCounter. Returns the new polygon index.
+int addPolygon(Graph &graph, List<List<Vertex>> &polygons,
+               List<Vertex> *polygon, int &visibleCounter) {
+    // Can't have a polygon with fewer than 3 vertices
+    assert(polygon->size() >= 3);
+    
+    // One past the largest index in use
+    int polygonIndex = 0;
+    List<List<Vertex>>::Iterator endP = polygons.end();
+    for (List<List<Vertex>>::Iterator pgon = polygons.begin(); pgon != endP;
+         ++pgon) {
+        polygonIndex = max(polygonIndex, (*(*pgon)->begin())->polygon + 1);
+    }
+    
+    // Number the new vertices the way read_polygons does
+    int location = 0;
+    List<Vertex>::Iterator endV = polygon->end();
+    for (List<Vertex>::Iterator v = polygon->begin(); v != endV; ++v) {
+        (*v)->polygon = polygonIndex;
+        (*v)->location = location++;
+        (*v)->poly_size = polygon->size();
+    }
+    
+    // An existing edge stays visible unless the new boundary blocks it.
+    // Its endpoints are outside the new polygon, so it cannot pass through
+    // the interior without crossing the boundary.
+    const BoundingBox box = polygonBox(*polygon);
+    graph.connections.removeIf([&](const Edge *e) {
+        return mayCross(*e->v1, *e->v2, box) &&
+               crossesPolygon(*e->v1, *e->v2, *polygon, visibleCounter);
+    });
+    
+    polygons.insertEnd(polygon);
+    PolygonCones cones;
+    findPolygonCones(polygons, cones);
+    
+    // Add copies of the new vertices after the old ones
+    const int oldVertices = graph.vertices.size();
+    for (List<Vertex>::Iterator v = polygon->begin(); v != endV; ++v) {
+        Vertex *newVert = new Vertex;
+        *newVert = **v;
+        graph.vertices.insertEnd(newVert);
+    }
+    
+    // Connect each new vertex to every old vertex and to the new vertices
+    // listed after it
+    List<Vertex>::Iterator end = graph.vertices.end();
+    int i = 0;
+    for (List<Vertex>::Iterator v = graph.vertices.begin(); v != end;
+         ++v, ++i) {
+        if (i < oldVertices) {
+            continue;
+        }
+        int j = 0;
+        for (List<Vertex>::Iterator check = graph.vertices.begin();
+             check != end; ++check, ++j) {
+            if (j >= oldVertices && j <= i) {
+                continue;
+            }
+            if (visible(**v, **check, polygons, visibleCounter, &cones)) {
+                double distance = distanceFormula(**v, **check);
+                graph.connections.insertEnd(new Edge{*v, *check, distance});
+            }
+        }
+    }
+    
+    return polygonIndex;
+}
+
+// REQUIRES: graph was built from polygons as for addPolygon, polygonIndex is
+//           the polygon index of a polygon in polygons
+// MODIFIES: graph, polygons, visibleCounter
+// EFFECTS : Removes that polygon from polygons (deleting it), and its vertices
+//           and their edges from graph. Then adds an edge for every pair of
+//           remaining vertices that it was blocking and that can now see each
+//           other. Adds the number of segment tests to visibleCounter.
+void removePolygon(Graph &graph, List<List<Vertex>> &polygons,
+                   int polygonIndex, int &visibleCounter) {
+    List<Vertex> *removed = nullptr;
+    List<List<Vertex>>::Iterator endP = polygons.end();
+    for (List<List<Vertex>>::Iterator pgon = polygons.begin(); pgon != endP;
+         ++pgon) {
+        if ((*(*pgon)->begin())->polygon == polygonIndex) {
+            removed = *pgon;
+            break;
+        }
+    }
+    // polygonIndex must be in use
+    assert(removed != nullptr);
+    
+    // polygons no longer owns removed, it is deleted at the end
+    polygons.removeValue(removed);
+    
+    // Drop the edges first, they point at the vertices
+    graph.connections.removeIf([polygonIndex](const Edge *e) {
+        return e->v1->polygon == polygonIndex ||
+               e->v2->polygon == polygonIndex;
+    });
+    graph.vertices.removeIf([polygonIndex](const Vertex *v) {
+        return v->polygon == polygonIndex;
+    });
+    
+    // Only pairs whose segment crossed the removed boundary were blocked by
+    // it. Pairs on the same polygon do not depend on other polygons (start
+    // and goal are both -1 but are not on a polygon).
+    vector<const Vertex*> remaining;
+    remaining.reserve(graph.vertices.size());
+    List<Vertex>::Iterator endV = graph.vertices.end();
+    for (List<Vertex>::Iterator v = graph.vertices.begin(); v != endV; ++v) {
+        remaining.push_back(*v);
+    }
+    
+    PolygonCones cones;
+    findPolygonCones(polygons, cones);
+    const BoundingBox box = polygonBox(*removed);
+    for (int i = 0; i < (int) remaining.size(); ++i) {
+        const Vertex &v = *remaining[i];
+        for (int j = i + 1; j < (int) remaining.size(); ++j) {
+            const Vertex &check = *remaining[j];
+            if ((v.polygon == check.polygon && v.polygon != -1) ||
+                !mayCross(v, check, box) ||
+                !crossesPolygon(v, check, *removed, visibleCounter)) {
+                continue;
+            }
+            if (visible(v, check, polygons, visibleCounter, &cones)) {
+                double distance = distanceFormula(v, check);
+                graph.connections.insertEnd(new Edge{&v, &check, distance});
+            }
+        }
+    }
+    
+    delete removed;
+}
+
+// Coordinates of both endpoints of an edge, smaller endpoint first
+typedef array<double, 2 * DIMENSIONS> EdgeKey;
+
+// EFFECTS : Fills vertices and edges with the sorted coordinates of graph
+static void graphKeys(const Graph &graph,
+                      vector<array<double, DIMENSIONS>> &vertices,
+                      vector<EdgeKey> &edges) {
+    List<Vertex>::Iterator endV = graph.vertices.end();
+    for (List<Vertex>::Iterator v = graph.vertices.begin(); v != endV; ++v) {
+        array<double, DIMENSIONS> key;
+        copy((*v)->coord, (*v)->coord + DIMENSIONS, key.begin());
+        vertices.push_back(key);
+    }
+    
+    List<Edge>::Iterator endE = graph.connections.end();
+    for (List<Edge>::Iterator e = graph.connections.begin(); e != endE; ++e) {
+        const Vertex *first = (*e)->v1;
+        const Vertex *second = (*e)->v2;
+        if (lexicographical_compare(second->coord, second->coord + DIMENSIONS,
+                                    first->coord, first->coord + DIMENSIONS)) {
+            swap(first, second);
+        }
+        EdgeKey key;
+        copy(first->coord, first->coord + DIMENSIONS, key.begin());
+        copy(second->coord, second->coord + DIMENSIONS,
+             key.begin() + DIMENSIONS);
+        edges.push_back(key);
+    }
+    
+    sort(vertices.begin(), vertices.end());
+    sort(edges.begin(), edges.end());
+}
+
+// EFFECTS : Returns true if lhs and rhs have the same vertex coordinates and
+//           connect the same pairs of coordinates, in any order.
+bool sameVisibilityGraph(const Graph &lhs, const Graph &rhs) {
+    if (lhs.vertices.size() != rhs.vertices.size() ||
+        lhs.connections.size() != rhs.connections.size()) {
+        return false;
+    }
+    
+    vector<array<double, DIMENSIONS>> lhsVertices, rhsVertices;
+    vector<EdgeKey> lhsEdges, rhsEdges;
+    graphKeys(lhs, lhsVertices, lhsEdges);
+    graphKeys(rhs, rhsVertices, rhsEdges);
+    return lhsVertices == rhsVertices && lhsEdges == rhsEdges;
+}
@@ -0,0 +1,47 @@
+//
+//  incremental.h
+//  Visibility Graph Path Planning
+//
+//  Adds or removes one convex obstacle in an existing visibility graph
+//  without rebuilding it. Adding a polygon only has to drop the edges that
+//  cross its boundary and connect its own vertices to the rest of the graph.
+//  Removing one only has to drop its vertices and re-test the pairs of
+//  vertices whose segment crossed it, since every other pair keeps the
+//  visibility it already had. Either way the edge set ends up the same as a
+//  full preProcess of the new set of polygons.
+//
+
+#ifndef incremental_h
+#define incremental_h
+
+#include "preprocessing.h"
+
+// REQUIRES: graph was built from polygons by preProcess (possibly followed by
+//           other calls to addPolygon and removePolygon, and by attaching
+//           start and goal), polygon is a convex polygon of at least 3
+//           vertices that does not overlap, touch, or contain any polygon in
+//           polygons or any vertex of graph
+// MODIFIES: graph, polygons, polygon, visibleCounter
+// EFFECTS : Gives polygon an unused polygon index and appends it to polygons
+//           (which takes ownership). Removes the edges of graph that cross
+//           polygon's boundary, then adds polygon's vertices and every edge
+//           they have to the other vertices. Adds the number of segment tests
+//           to visibleCounter. Returns the new polygon index.
+int addPolygon(Graph &graph, List<List<Vertex>> &polygons,
+               List<Vertex> *polygon, int &visibleCounter);
+
+// REQUIRES: graph was built from polygons as for addPolygon, polygonIndex is
+//           the polygon index of a polygon in polygons
+// MODIFIES: graph, polygons, visibleCounter
+// EFFECTS : Removes that polygon from polygons (deleting it), and its vertices
+//           and their edges from graph. Then adds an edge for every pair of
+//           remaining vertices that it was blocking and that can now see each
+//           other. Adds the number of segment tests to visibleCounter.
+void removePolygon(Graph &graph, List<List<Vertex>> &polygons,
+                   int polygonIndex, int &visibleCounter);
+
+// EFFECTS : Returns true if lhs and rhs have the same vertex coordinates and
+//           connect the same pairs of coordinates, in any order.
+bool sameVisibilityGraph(const Graph &lhs, const Graph &rhs);
+
+#endif /* incremental_h */
@@ -0,0 +1,129 @@
+//
+//  landmarks.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <limits>
+#include "landmarks.h"
+
+using namespace std;
+
+// REQUIRES: graph has been pre-processed (does not contain start and goal),
+//           numLandmarks > 0, landmarks is empty
+// MODIFIES: landmarks, loopCounter
+// EFFECTS : Selects up to numLandmarks vertices of graph by farthest-point
+//           selection (each new landmark is the vertex farthest, by shortest
+//           path, from all landmarks chosen so far) and stores the distance
+//           table of each. Adds the number of vertices settled by the
+//           shortest path searches to loopCounter.
+void selectLandmarks(const Graph &graph, int numLandmarks,
+                     Landmarks &landmarks, int &loopCounter) {
+    assert(numLandmarks > 0);
+    assert(landmarks.landmarkVertices.empty());
+
+    buildAdjacency(graph, landmarks.adjacency);
+
+    const int numVertices = (int) landmarks.adjacency.vertices.size();
+    if (numVertices == 0) {
+        return;
+    }
+    if (numLandmarks > numVertices) {
+        numLandmarks = numVertices;
+    }
+
+    // The first vertex is an arbitrary choice, so start from whichever vertex
+    // is farthest from it instead
+    vector<double> fromFirst;
+    shortestPaths(landmarks.adjacency, 0, fromFirst, loopCounter);
+
+    // Distance from each vertex to its closest landmark so far. Starts out as
+    // the distances from vertex 0 so that the first pick is the farthest
+    // vertex from it.
+    vector<double> closestLandmark = fromFirst;
+    vector<bool> isLandmark(numVertices, false);
+
+    for (int k = 0; k < numLandmarks; ++k) {
+        // Farthest vertex from all current landmarks. Unreachable vertices
+        // (infinity) are picked first so every component gets a landmark.
+        int next = -1;
+        for (int i = 0; i < numVertices; ++i) {
+            if (!isLandmark[i] &&
+                (next == -1 || closestLandmark[i] > closestLandmark[next])) {
+                next = i;
+            }
+        }
+
+        isLandmark[next] = true;
+        landmarks.landmarkVertices.push_back(next);
+        landmarks.distances.push_back(vector<double>());
+        vector<double> &table = landmarks.distances.back();
+        shortestPaths(landmarks.adjacency, next, table, loopCounter);
+
+        for (int i = 0; i < numVertices; ++i) {
+            // The distances from vertex 0 only seeded the first choice
+            if (k == 0 || table[i] < closestLandmark[i]) {
+                closestLandmark[i] = table[i];
+            }
+        }
+    }
+}
+
+// EFFECTS : Returns the number of bytes used by the distance tables
+size_t landmarksMemory(const Landmarks &landmarks) {
+    size_t bytes = 0;
+    for (int k = 0; k < (int) landmarks.distances.size(); ++k) {
+        bytes += landmarks.distances[k].size() * sizeof(double);
+    }
+    return bytes;
+}
+
+// REQUIRES: landmarks was built from the graph searchGraph was copied from.
+//           point is either one of the landmarks' vertices or has been
+//           attached to searchGraph (see visibleVertices).
+// MODIFIES: pointDistances
+// EFFECTS : Sets pointDistances[k] to the shortest path distance from
+//           landmark k to point (infinity if unreachable)
+void landmarkDistances(const Landmarks &landmarks, const Graph &searchGraph,
+                       const Vertex *point,
+                       std::vector<double> &pointDistances) {
+    const int numLandmarks = (int) landmarks.distances.size();
+    pointDistances.assign(numLandmarks, numeric_limits<double>::infinity());
+
+    // A vertex in the tables can be looked up directly
+    int pointIndex = vertexIndex(landmarks.adjacency, point);
+    if (pointIndex != -1) {
+        for (int k = 0; k < numLandmarks; ++k) {
+            pointDistances[k] = landmarks.distances[k][pointIndex];
+        }
+        return;
+    }
+
+    // Otherwise the shortest path reaches point through one of the vertices
+    // it can see
+    List<Edge>::Iterator end = searchGraph.connections.end();
+    for (List<Edge>::Iterator e = searchGraph.connections.begin(); e != end;
+         ++e) {
+        const Vertex *other = nullptr;
+        if ((*e)->v1 == point) {
+            other = (*e)->v2;
+        } else if ((*e)->v2 == point) {
+            other = (*e)->v1;
+        } else {
+            continue;
+        }
+
+        int otherIndex = vertexIndex(landmarks.adjacency, other);
+        if (otherIndex == -1) {
+            // Edge to the other query point (start <-> goal)
+            continue;
+        }
+        for (int k = 0; k < numLandmarks; ++k) {
+            double throughOther =
+                landmarks.distances[k][otherIndex] + (*e)->length;
+            if (throughOther < pointDistances[k]) {
+                pointDistances[k] = throughOther;
+            }
+        }
+    }
+}
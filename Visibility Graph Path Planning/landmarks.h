@@ -0,0 +1,54 @@
+//
+//  landmarks.h
+//  Visibility Graph Path Planning
+//
+//  ALT (A*, Landmarks, Triangle inequality) preprocessing. A few polygon
+//  vertices are chosen as landmarks and the shortest path distance from each
+//  landmark to every vertex is stored. For any vertex n and landmark L,
+//  |d(L, goal) - d(L, n)| <= d(n, goal), which gives a lower bound on the
+//  remaining distance that is usually much tighter than the straight line in
+//  cluttered maps.
+//
+
+#ifndef landmarks_h
+#define landmarks_h
+
+#include <vector>
+#include "preprocessing.h"
+#include "adjacency.h"
+
+struct Landmarks {
+    // Indexed view of the graph the landmarks were selected from
+    AdjacencyGraph adjacency;
+    // Vertex index (in adjacency) of each landmark
+    std::vector<int> landmarkVertices;
+    // distances[k][i] is the shortest path distance from landmark k to vertex
+    // i (infinity if unreachable)
+    std::vector<std::vector<double>> distances;
+};
+
+// REQUIRES: graph has been pre-processed (does not contain start and goal),
+//           numLandmarks > 0, landmarks is empty
+// MODIFIES: landmarks, loopCounter
+// EFFECTS : Selects up to numLandmarks vertices of graph by farthest-point
+//           selection (each new landmark is the vertex farthest, by shortest
+//           path, from all landmarks chosen so far) and stores the distance
+//           table of each. Adds the number of vertices settled by the
+//           shortest path searches to loopCounter.
+void selectLandmarks(const Graph &graph, int numLandmarks,
+                     Landmarks &landmarks, int &loopCounter);
+
+// EFFECTS : Returns the number of bytes used by the distance tables
+size_t landmarksMemory(const Landmarks &landmarks);
+
+// REQUIRES: landmarks was built from the graph searchGraph was copied from.
+//           point is either one of the landmarks' vertices or has been
+//           attached to searchGraph (see visibleVertices).
+// MODIFIES: pointDistances
+// EFFECTS : Sets pointDistances[k] to the shortest path distance from
+//           landmark k to point (infinity if unreachable)
+void landmarkDistances(const Landmarks &landmarks, const Graph &searchGraph,
+                       const Vertex *point,
+                       std::vector<double> &pointDistances);
+
+#endif /* landmarks_h */
@@ -9,42 +9,163 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <sstream>
 #include <vector>
 #include <cassert>
 #include <math.h>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
 #include "List.h"
 #include "preprocessing.h"
 #include "AStarProblem.h"
 #include "search_functions.h"
+#include "landmarks.h"
+#include "contraction.h"
+#include "distance_oracle.h"
+#include "incremental.h"
+#include "dstar_lite.h"
+#include "snapshot.h"
+#include "tiles.h"
+#include "streaming.h"
+#include "search_engine.h"
+#include "reorder.h"
+#include "simplify.h"
+#include "validate.h"
+#include "point_location.h"
+#include "map_generator.h"
+#include "results.h"
+#include "trace.h"
+#include "perf_counters.h"
+#include "search_context.h"
 
 using namespace std;
 
-const double PI = 3.14159265358979323846;
 // Parameters for testing
 static const int MAXPOLYGONS = 100;
 static const int MAXVERTICES = 20;
 static const int NUMOFSEARCHES = 20;
+// Centers drawn in a row inside existing circles before map generation
+// gives up placing more polygons
+static const int MAXPLACEMENTATTEMPTS = 100000;
+// Number of ALT landmarks (0 disables the landmark heuristic comparison)
+static const int NUMOFLANDMARKS = 0;
+// Whether to compare contraction hierarchy queries against A*
+static const bool USECONTRACTION = false;
+// Memory ceiling in bytes for the all-pairs distance oracle (0 disables it)
+static const size_t ORACLEMEMORYLIMIT = 0;
+// Heuristic inflation for a weighted A* comparison (1 disables it)
+static const double SEARCHINFLATION = 1.0;
+// Elapsed seconds given to each anytime (ARA*) search (0 disables it),
+// with its initial inflation and the amount the inflation drops per iteration
+static const double ANYTIMEBUDGET = 0;
+static const double ANYTIMEEPSILON = 3.0;
+static const double ANYTIMESTEP = 0.5;
+// Limits on each A* search: elapsed seconds and number of node
+// expansions (0 means no limit)
+static const double SEARCHTIMEBUDGET = 0;
+static const int SEARCHEXPANSIONBUDGET = 0;
+// Whether to time removing and re-adding a random polygon incrementally and
+// check the results against full rebuilds
+static const bool INCREMENTALTEST = false;
+// Number of map updates to replan after with D* Lite, comparing each replan
+// against a cold A* search (0 disables it)
+static const int DSTARREPLANS = 0;
+// Number of query threads for the snapshot stress benchmark (0 disables it),
+// and the number of rebuilt snapshots published while they run
+static const int SNAPSHOTREADERS = 0;
+static const int SNAPSHOTSWAPS = 4;
+// Tiles per side for the hierarchical tiled graph (0 disables it), portals
+// per border between two tiles, and threads used to build the tiles
+static const int TILESPERSIDE = 0;
+static const int PORTALSPERBORDER = 4;
+static const int TILETHREADS = 2;
+// Edge buffer size in bytes for the out-of-core streaming build, whose
+// memory-mapped graph is searched alongside A* (0 disables it)
+static const size_t STREAMINGBUDGET = 0;
+// Fixed-point coordinate resolution (0 keeps floating-point coordinates)
+static const double FIXEDRESOLUTION = 0;
+// Whether to repeat each search with policySearch under several open list,
+// closed set and node storage policies
+static const bool POLICYBENCHMARK = false;
+// Order of the graph's vertices in memory after preprocessing (FILE_ORDER,
+// MORTON_ORDER or HILBERT_ORDER)
+static const VertexOrder VERTEXORDER = FILE_ORDER;
+// Tolerance for simplifying convex polygons before the graph is built (0
+// disables it). Testing mode builds a simplified graph next to the original
+// and repeats each search on it.
+static const double SIMPLIFYTOLERANCE = 0;
+// Whether to check the polygon preconditions of preProcess (convex, same
+// orientation, no overlaps or shared vertices) when polygons are loaded.
+// Single-run mode stops on an invalid file.
+static const bool VALIDATEPOLYGONS = true;
+// Distance to move a start or goal point that lies inside a polygon out past
+// the polygon's boundary in single-run mode (0 rejects such points instead)
+static const double SNAPMARGIN = 0;
+// Number of random points located with the point location index in testing
+// mode, timed against testing every polygon (0 disables it)
+static const int POINTQUERIES = 0;
+// Which testing results to write: the text format ("output.out") and the
+// fixed-schema CSV records ("results.csv", see results.h)
+static const bool TEXTRESULTS = true;
+static const bool CSVRESULTS = false;
+// Whether to record the time spent in each phase (reading polygons, building
+// the graph, attaching start and goal, each search, writing results) to
+// "trace.json" in the Chrome trace format (see trace.h)
+static const bool TRACEPHASES = false;
+// Whether to count CPU cycles, instructions, cache misses and branch misses
+// (Linux perf_event_open, see perf_counters.h) during map generation,
+// preprocessing and each A* search. Counters the system does not allow are
+// reported as -1.
+static const bool PERFCOUNTERS = false;
+// Seed for the random maps and start/goal points in testing mode (0 seeds
+// from the clock). Runs with the same nonzero seed test the same scenarios,
+// so their results can be compared with benchcompare.
+static const unsigned TESTSEED = 0;
+// Whether to repeat each A* search in testing mode with the thread's reusable
+// SearchContext (see search_context.h)
+static const bool REUSESEARCHCONTEXT = false;
 
 // Initializes start and goal using user input
 void Vertex_input (Vertex &start, Vertex &goal);
 
-// EFFECTS: Generates a random double between fMin and fMax
-double fRand(double fMin, double fMax);
+// Results of one query thread in the snapshot stress benchmark
+struct ReaderStats {
+    int queries;
+    // Latency of all queries, in microseconds
+    double totalMicros;
+    double maxMicros;
+    // Queries during which a new snapshot was published, and their latency
+    int swapQueries;
+    double swapMicros;
+};
 
-// REQUIRES: arr points to the first element of a valid array of size doubles
-// MODFIEIS: arr
-// EFFECTS : Sorts arr from smallest to largest
-void insertionSort(double *arr, int size);
+// REQUIRES: startPoints and endPoints hold NUMOFSEARCHES points outside every
+//           polygon of every snapshot published to registry
+// MODIFIES: stats
+// EFFECTS : Runs snapshotSearch on the current snapshot of registry over and
+//           over until stop is set, recording each query's latency in stats
+void snapshotReader(const SnapshotRegistry &registry,
+                    const Vertex *startPoints, const Vertex *endPoints,
+                    const atomic<bool> &stop, ReaderStats &stats);
 
-// MODIFIES: a, b
-// EFFECTS : Swaps the values of a and b
-void swap (double &a, double &b);
+// REQUIRES: SearchProblem is a problem type for policySearch that can use the
+//           given policies (see search_engine.h)
+// MODIFIES: os
+// EFFECTS : Runs policySearch on p and writes " nodesExpanded clockTicks
+//           distance" to os
+template <class OpenList, template <class> class ClosedSet,
+          template <class> class NodeStorage, class SearchProblem>
+void timePolicies(const SearchProblem &p, ostream &os);
 
-// REQUIRES: testIndex >= 0 and testIndex < numOfTests, polygonFile and
-//           outputFile are open
+// REQUIRES: testIndex >= 0 and testIndex < numOfTests, polygonFile is open
 // EFFECTS : Produces a visibility graph and runs AStarSearches on the graph.
-//           Outputs the results to output[testIndex].txt
-void runTest(int testIndex, ostream &polygonFile, ostream &outputFile);
+//           Outputs the results to outputFile (text) and resultsFile (CSV
+//           records); either may be a closed stream, which discards them.
+void runTest(int testIndex, ostream &polygonFile, ostream &outputFile,
+             ostream &resultsFile);
 
 int main(int argc, const char * argv[]) {
     
@@ -57,15 +178,38 @@ int main(int argc, const char * argv[]) {
 //    const int numOfTests = 1000;
 //
 //    // Seed random number generation
-//    srand((int) time(nullptr));
+//    srand(TESTSEED != 0 ? TESTSEED : (unsigned) time(nullptr));
 //
-//    // Create polygons and output files
+//    if (TRACEPHASES) {
+//        startTrace();
+//    }
+//
+//    if (PERFCOUNTERS) {
+//        // Say once why counts will be -1 (each test opens its own counters)
+//        PerfCounters probe;
+//        if (probe.open() < NUM_PERF_EVENTS) {
+//            cout << "Some performance counters are unavailable ("
+//                 << probe.unavailableReason() << ")" << endl;
+//        }
+//    }
+//
+//    // Create polygons and output files (writes to a closed file are
+//    // discarded)
 //    ofstream polygonFile("output_polygons.out");
-//    ofstream outputFile("output.out");
+//    ofstream outputFile;
+//    if (TEXTRESULTS) {
+//        outputFile.open("output.out");
+//    }
+//    ofstream resultsFile;
+//    if (CSVRESULTS) {
+//        resultsFile.open("results.csv");
+//        resultsFile.precision(17);
+//        writeResultsHeader(resultsFile);
+//    }
 //
 //    // Each test
 //    for (int testIndex = 0; testIndex < numOfTests; ++testIndex) {
-//        runTest(testIndex, polygonFile, outputFile);
+//        runTest(testIndex, polygonFile, outputFile, resultsFile);
 //    }
 //
 //    // Output total testing time and testing parameters
@@ -76,11 +220,21 @@ int main(int argc, const char * argv[]) {
 //
 //    polygonFile.close();
 //    outputFile.close();
+//    resultsFile.close();
+//
+//    if (TRACEPHASES) {
+//        stopTrace();
+//        writeTrace("trace.json");
+//    }
     
     ////////////// End testing code //////////////////////
     
     ////////////// Begin single run code //////////////////////
     
+    if (TRACEPHASES) {
+        startTrace();
+    }
+    
     // Take in polygon file
     cout << "Enter a filename (polygon obstacles): ";
     string polygon_filename;
@@ -96,6 +250,16 @@ int main(int argc, const char * argv[]) {
         return 1;
     }
 
+    // Coordinates are snapped as they are read
+    setFixedPointResolution(FIXEDRESOLUTION);
+    
+    PerfCounters perf;
+    if (PERFCOUNTERS && perf.open() < NUM_PERF_EVENTS) {
+        cout << "Some performance counters are unavailable ("
+             << perf.unavailableReason() << ")" << endl;
+    }
+    perf.start();
+    
     // Testing Preprocessing (see README)
     Graph g;
     // Hold the polygons List in main for checking the start and goal
@@ -103,8 +267,29 @@ int main(int argc, const char * argv[]) {
 
     // Need dummy counters (see testing code for actual use)
     int dummyCounter = 0;
-    preProcess(g, polygon_fin, polygons, dummyCounter, dummyCounter,
-               dummyCounter, dummyCounter, dummyCounter);
+    if (VALIDATEPOLYGONS || SIMPLIFYTOLERANCE > 0) {
+        // Same as preProcess, with the polygons checked and simplified before
+        // the graph is built
+        read_polygons(polygons, polygon_fin, dummyCounter);
+        if (VALIDATEPOLYGONS) {
+            ValidationReport report;
+            if (!validatePolygons(polygons, report)) {
+                printValidationReport(cout, report);
+                return 1;
+            }
+        }
+        if (SIMPLIFYTOLERANCE > 0) {
+            simplifyPolygons(polygons, SIMPLIFYTOLERANCE, dummyCounter);
+        }
+        addVertices(g, polygons, dummyCounter);
+        makeConnections(g, polygons, dummyCounter, dummyCounter,
+                        dummyCounter);
+    } else {
+        preProcess(g, polygon_fin, polygons, dummyCounter, dummyCounter,
+                   dummyCounter, dummyCounter, dummyCounter);
+    }
+    reorderVertices(g, VERTEXORDER, dummyCounter);
+    PerfSample preprocessPerf = perf.stop();
 
     polygon_fin.close();
 
@@ -115,6 +300,26 @@ int main(int argc, const char * argv[]) {
     // Take start and goal input for A*
     Vertex_input(*start, *goal);
 
+    // Start and goal must not be inside a polygon (see visibleVertices)
+    PointLocationIndex pointIndex;
+    buildPointLocationIndex(polygons, pointIndex, dummyCounter);
+    Vertex *queryPoints[2] = {start, goal};
+    for (int i = 0; i < 2; ++i) {
+        int polygon = containingPolygon(pointIndex, *queryPoints[i]);
+        if (polygon == -1) {
+            continue;
+        }
+        cout << (i == 0 ? "Start" : "Goal") << " point is inside polygon "
+             << polygon << endl;
+        if (SNAPMARGIN <= 0 ||
+            !snapOutOfObstacle(pointIndex, *queryPoints[i], SNAPMARGIN)) {
+            delete start;
+            delete goal;
+            return 1;
+        }
+        cout << "Moved to " << *queryPoints[i] << endl;
+    }
+
     // Create start and goal states
     State startState = {start};
     State goalState = {goal};
@@ -128,7 +333,7 @@ int main(int argc, const char * argv[]) {
     // Check visibility between start and goal
     if (visible(*start, *goal, polygons, dummyCounter)) {
         // Create and print the solution
-        cout << "Distance: " << distanceFormula(*start, *goal, DIMENSIONS)
+        cout << "Distance: " << distanceFormula(*start, *goal)
              << endl;
         solution.push_back(goalState);
         solution.push_back(startState);
@@ -146,25 +351,45 @@ int main(int argc, const char * argv[]) {
     List<Vertex>::Iterator it_start = g.vertices.begin();
     List<Vertex>::Iterator it_goal = it_start;
     ++it_goal;
-    visibleVertices(it_start, g, polygons, dummyCounter, dummyCounter);
-    visibleVertices(it_goal, g, polygons, dummyCounter, dummyCounter);
+    {
+        TraceScope trace("attach start and goal");
+        visibleVertices(it_start, g, polygons, dummyCounter, dummyCounter);
+        visibleVertices(it_goal, g, polygons, dummyCounter, dummyCounter);
+    }
     // Now, start and goal should be properly inserted in the graph
 
     // Perform an A* search
     size_t dummySize = 0;
+    perf.start();
     double distance = AStarSearch(prob, solution, dummyCounter, dummyCounter,
                                   dummySize);
+    PerfSample searchPerf = perf.stop();
     // Print solution
     cout << "Distance: " << distance << endl;
     prob.printSolution(solution, cout);
     
+    if (PERFCOUNTERS) {
+        // Cycles, instructions, cache misses, branch misses (-1 if not
+        // available)
+        cout << "Preprocess counters: ";
+        printPerfSample(cout, preprocessPerf);
+        cout << endl << "Search counters: ";
+        printPerfSample(cout, searchPerf);
+        cout << endl;
+    }
+    
+    if (TRACEPHASES) {
+        stopTrace();
+        writeTrace("trace.json");
+    }
+    
     ////////////// End single run code //////////////////////
      
     return 0;
 }
 
 void Vertex_input (Vertex &start, Vertex &goal) {
-    assert(DIMENSIONS == 2);
+    static_assert(DIMENSIONS == 2, "Vertex_input reads two coordinates");
     cout << "Enter a starting point (format: \"x y\")" << endl;
     double x_in, y_in;
     cin >> x_in >> y_in;
@@ -182,34 +407,68 @@ void Vertex_input (Vertex &start, Vertex &goal) {
     goal.polygon = -1;
     goal.location = -1;
     goal.poly_size = -1;
+    snapToGrid(start);
+    snapToGrid(goal);
 }
 
-double fRand(double fMin, double fMax)
-{
-    double f = (double)rand() / RAND_MAX;
-    return fMin + f * (fMax - fMin);
-}
-
-void insertionSort(double *arr, int size) {
-    for (int i = 1; i < size; ++i) {
-        for (int j = i; j > 0; --j) {
-            if (arr[j - 1] > arr[j]) {
-                break;
-            }
-            swap(arr[j], arr[j - 1]);
+void snapshotReader(const SnapshotRegistry &registry,
+                    const Vertex *startPoints, const Vertex *endPoints,
+                    const atomic<bool> &stop, ReaderStats &stats) {
+    stats = ReaderStats{0, 0, 0, 0, 0};
+    while (!stop) {
+        // Local copies, since the search attaches them to its graph
+        Vertex start = startPoints[stats.queries % NUMOFSEARCHES];
+        Vertex goal = endPoints[stats.queries % NUMOFSEARCHES];
+        
+        chrono::steady_clock::time_point queryStart =
+            chrono::steady_clock::now();
+        shared_ptr<const GraphSnapshot> snapshot = registry.pin();
+        vector<State> solution;
+        int nodesExpanded = 0;
+        snapshotSearch(*snapshot, &start, &goal, solution, nodesExpanded);
+        bool swapped = registry.version() != snapshot->version;
+        double micros = chrono::duration<double, micro>(
+            chrono::steady_clock::now() - queryStart).count();
+        
+        ++stats.queries;
+        stats.totalMicros += micros;
+        stats.maxMicros = max(stats.maxMicros, micros);
+        if (swapped) {
+            ++stats.swapQueries;
+            stats.swapMicros += micros;
         }
     }
 }
 
-void swap (double &a, double &b) {
-    double temp = a;
-    a = b;
-    b = temp;
+template <class OpenList, template <class> class ClosedSet,
+          template <class> class NodeStorage, class SearchProblem>
+void timePolicies(const SearchProblem &p, ostream &os) {
+    vector<typename SearchProblem::StateType> solution;
+    int nodesExpanded = 0;
+    int maxNodes = 0;
+    clock_t searchStart = clock();
+    double distance = policySearch<OpenList, ClosedSet, NodeStorage>(
+        p, solution, nodesExpanded, maxNodes);
+    os << " " << nodesExpanded << " " << clock() - searchStart << " "
+       << distance;
 }
 
-void runTest(int testIndex, ostream &polygonFile, ostream &outputFile) {
+void runTest(int testIndex, ostream &polygonFile, ostream &outputFile,
+             ostream &resultsFile) {
+    TraceScope trace("test", testIndex);
+    
+    // Hardware counters for this thread (left closed unless PERFCOUNTERS,
+    // which makes start and stop do nothing)
+    PerfCounters perf;
+    if (PERFCOUNTERS) {
+        perf.open();
+    }
     
     clock_t generationStart = clock(); // Time in clock ticks
+    perf.start();
+    
+    // Coordinates are snapped as they are generated and read
+    setFixedPointResolution(FIXEDRESOLUTION);
     
     // Output test index to both output files
     polygonFile << "test_";
@@ -232,86 +491,20 @@ void runTest(int testIndex, ostream &polygonFile, ostream &outputFile) {
     // to (100, 100) at top right
     
     //random int in interval [1,MAXPOLYGONS]
-    const int numOfPolygons = (rand() % MAXPOLYGONS) + 1;
-    int totalVertices = 0;
-    
-    // Store center coordinates and radii of all circles to avoid overlap
-    Vertex *arrCenters = new Vertex[numOfPolygons];
-    double *arrRadii = new double[numOfPolygons];
+    const int requestedPolygons = (rand() % MAXPOLYGONS) + 1;
     
-    // Create single polygons file for this test
-    // Set high precision to avoid floating-point errors during testing
-    ofstream localPolygonFile("polygons.txt");
-    localPolygonFile.precision(20);
+    // Place the polygons in circles that do not overlap (see map_generator)
+    MapGenerator generator((unsigned) rand(), 100);
+    const int numOfPolygons = generator.generate(requestedPolygons,
+                                                 MAXVERTICES,
+                                                 MAXPLACEMENTATTEMPTS);
+    const int totalVertices = generator.numVertices();
     
-    // Each polygon to be generated
-    for (int polygonIndex = 0; polygonIndex < numOfPolygons; ++polygonIndex) {
-        
-        bool polygonPlaced = false;
-        while (!polygonPlaced) {
-            // Set a random center point
-            Vertex center = {fRand(-100, 100), fRand(-100, 100), -1, -1, -1};
-            
-            // Find upper bound on radius
-            // First, base upper bound on position of center
-            double upperBoundRadius = min(100 - fabs(center.coord[0]),
-                                          100 - fabs(center.coord[1]));
-            // Then, update upper bound based on other polygons
-            for (int i = 0; i < polygonIndex; ++i) {
-                double maxLocalRadius =
-                    distanceFormula(center, arrCenters[i], DIMENSIONS)
-                    - arrRadii[i];
-                
-                if (maxLocalRadius < upperBoundRadius) {
-                    upperBoundRadius = maxLocalRadius;
-                }
-                if (upperBoundRadius <= 0) {
-                    // Need to pick new center (current center is within an
-                    // existing circle)
-                    break;
-                }
-            }
-            
-            if (upperBoundRadius <= 0) { continue; }
-            
-            // Now, can be certain that center and radius are acceptable
-            double radius = fRand(0, upperBoundRadius);
-            
-            // Store center and radius for future
-            arrCenters[polygonIndex] = center;
-            arrRadii[polygonIndex] = radius;
-            
-            //random int in [3,MAXVERTICES]
-            int numOfVertices = (rand() % (MAXVERTICES - 2)) + 3;
-            // Store an angle for each vertex to be placed
-            double *angles = new double[numOfVertices];
-            // Fill with random angles [0, 2*PI]
-            for (int i = 0; i < numOfVertices; ++i) {
-                angles[i] = fRand(0, 2 * PI);
-            }
-            // Sort angles into CCW order
-            insertionSort(angles, numOfVertices);
-            
-            // Write to polygons file
-            polygonFile << numOfVertices << endl;
-            localPolygonFile << numOfVertices << endl;
-            for (int i = 0; i < numOfVertices; ++i) {
-                double xCoord = center.coord[0] + radius * cos(angles[i]);
-                double yCoord = center.coord[1] + radius * sin(angles[i]);
-                polygonFile << xCoord << " " << yCoord << " ";
-                localPolygonFile << xCoord << " " << yCoord << " ";
-            }
-            polygonFile << endl;
-            localPolygonFile << endl;
-            
-            totalVertices += numOfVertices;
-            delete [] angles;
-            polygonPlaced = true;
-        }
+    // Write to the polygons file
+    {
+        TraceScope polygonTrace("write polygons");
+        generator.write(polygonFile);
     }
-    
-    // Ends output to polygon files
-    localPolygonFile.close();
     polygonFile << endl;
     
     // number of polygons and number of vertices
@@ -321,50 +514,19 @@ void runTest(int testIndex, ostream &polygonFile, ostream &outputFile) {
     // inside any polygon
     Vertex startPoints[NUMOFSEARCHES];
     Vertex endPoints[NUMOFSEARCHES];
-    
-    for (int i = 0; i < 2*NUMOFSEARCHES; ++i) {
-        bool goodPoint = false;
-        while (!goodPoint) {
-            // Set a random point
-            Vertex point = {fRand(-100, 100), fRand(-100, 100), -1, -1, -1};
-            goodPoint = true;
-            for (int j = 0; j < numOfPolygons; ++j) {
-                // Check whether inside any polygon
-                if (distanceFormula(arrCenters[j], point, DIMENSIONS)
-                    <= arrRadii[j]) {
-                    goodPoint = false;
-                    break;
-                }
-            }
-            if (goodPoint) {
-                // Set as start or end
-                if (i % 2 == 0) {
-                    startPoints[i / 2] = point;
-                } else {
-                    endPoints[i / 2] = point;
-                }
-            }
-        }
+    for (int i = 0; i < NUMOFSEARCHES; ++i) {
+        startPoints[i] = generator.freePoint();
+        endPoints[i] = generator.freePoint();
     }
     
     // output time for generation (clock ticks)
-    outputFile << clock() - generationStart << endl << endl;
-    
-    // Circle info no longer needed
-    delete [] arrCenters;
-    arrCenters = nullptr;
-    delete [] arrRadii;
-    arrRadii = nullptr;
-    
-    // Check if polygon file opens properly
-    ifstream polygon_fin("polygons.txt");
-    if(!polygon_fin){
-        cout << "Error opening file: polygons.txt" << endl;
-        assert(false);
-    }
+    clock_t generationTime = clock() - generationStart;
+    PerfSample generationPerf = perf.stop();
+    outputFile << generationTime << endl << endl;
     
     // Start the clock for preprocessing
     clock_t preprocessStart = clock(); // Time in clock ticks
+    perf.start();
     
     // This graph will hold the visibility graph made up of only polygon
     // vertices (not start and goal points), allowing graphs for each run to be
@@ -379,26 +541,447 @@ void runTest(int testIndex, ostream &polygonFile, ostream &outputFile) {
     int visibleVerticesCounter = 0;
     int visibleCounter = 0;
     
-    // Create the visibility graph
-    preProcess(ownerGraph, polygon_fin, polygons, readPolygonsCounter,
-               addVerticesCounter, makeConnectionsCounter,
-               visibleVerticesCounter, visibleCounter);
+    // Count the orientation tests made while building it
+    predicateCounters() = PredicateCounters{0, 0, 0};
     
-    polygon_fin.close();
+    // Create the visibility graph, taking the polygons straight from the
+    // generator (the same ones preProcess would read from a file written at
+    // full precision)
+    {
+        TraceScope preprocessTrace("preProcess");
+        generator.toPolygons(polygons, readPolygonsCounter);
+        addVertices(ownerGraph, polygons, addVerticesCounter);
+        makeConnections(ownerGraph, polygons, makeConnectionsCounter,
+                        visibleVerticesCounter, visibleCounter);
+    }
     
     // Stop the clock for preprocessing
     clock_t preprocessTime = clock() - preprocessStart;
+    PerfSample preprocessPerf = perf.stop();
     
     // Output preprocess information to file
-    outputFile << ownerGraph.vertices.size() << " "
-               << ownerGraph.connections.size() << endl;
-    outputFile << readPolygonsCounter << " " << addVerticesCounter << " "
-               << makeConnectionsCounter << " " << visibleVerticesCounter << " "
-               << visibleCounter << endl;
-    outputFile << preprocessTime << endl << endl;
+    {
+        TraceScope outputTrace("write results");
+        outputFile << ownerGraph.vertices.size() << " "
+                   << ownerGraph.connections.size() << endl;
+        outputFile << readPolygonsCounter << " " << addVerticesCounter << " "
+                   << makeConnectionsCounter << " " << visibleVerticesCounter
+                   << " " << visibleCounter << endl;
+        outputFile << preprocessTime << endl;
+        GraphRecord graphRecord = {testIndex, numOfPolygons, totalVertices,
+                                   (long) generationTime,
+                                   ownerGraph.vertices.size(),
+                                   ownerGraph.connections.size(),
+                                   readPolygonsCounter, addVerticesCounter,
+                                   makeConnectionsCounter,
+                                   visibleVerticesCounter, visibleCounter,
+                                   (long) preprocessTime};
+        writeGraphRecord(resultsFile, graphRecord);
+        outputFile << "Predicates: " << predicateCounters().fast << " "
+                   << predicateCounters().exact << endl;
+        outputFile << "Cones: " << predicateCounters().coneRejections << endl;
+        outputFile << "Placement: " << generator.centerAttempts() << endl;
+        if (PERFCOUNTERS) {
+            outputFile << "Perf: ";
+            printPerfSample(outputFile, generationPerf);
+            outputFile << " ";
+            printPerfSample(outputFile, preprocessPerf);
+            outputFile << endl;
+        }
+    }
+    
+    // Optional check of the polygon preconditions (see README)
+    if (VALIDATEPOLYGONS) {
+        clock_t validateStart = clock();
+        ValidationReport report;
+        validatePolygons(polygons, report);
+        outputFile << "Validation: " << clock() - validateStart << " "
+                   << report.candidatePairs << " " << report.nonConvex.size()
+                   << " " << report.misoriented.size() << " "
+                   << report.sharedVertices.size() << " "
+                   << report.overlaps.size() << endl;
+    }
+    
+    // Optional point location benchmark (see README)
+    if (POINTQUERIES > 0) {
+        clock_t indexStart = clock();
+        int indexCounter = 0;
+        PointLocationIndex pointIndex;
+        buildPointLocationIndex(polygons, pointIndex, indexCounter);
+        clock_t indexTime = clock() - indexStart;
+        
+        // The generated start and end points avoid every polygon
+        vector<Vertex> searchPoints(startPoints, startPoints + NUMOFSEARCHES);
+        searchPoints.insert(searchPoints.end(), endPoints,
+                            endPoints + NUMOFSEARCHES);
+        vector<int> containing;
+        int blockedSearchPoints = locatePoints(pointIndex, searchPoints,
+                                               containing);
+        assert(blockedSearchPoints == 0);
+        
+        // Random points from their own generator, so the tests stay the
+        // same with and without the benchmark
+        mt19937 generator(testIndex);
+        uniform_real_distribution<double> coordinate(-100, 100);
+        vector<Vertex> queries(POINTQUERIES);
+        for (Vertex &query : queries) {
+            query.coord[0] = coordinate(generator);
+            query.coord[1] = coordinate(generator);
+            query.polygon = query.location = query.poly_size = -1;
+            snapToGrid(query);
+        }
+        clock_t queryStart = clock();
+        int blocked = locatePoints(pointIndex, queries, containing);
+        clock_t queryTime = clock() - queryStart;
+        
+        // The same queries testing every polygon
+        clock_t bruteStart = clock();
+        int bruteBlocked = 0;
+        for (const Vertex &query : queries) {
+            List<List<Vertex>>::Iterator endP = polygons.end();
+            for (List<List<Vertex>>::Iterator pgon = polygons.begin();
+                 pgon != endP; ++pgon) {
+                if (insideConvexPolygon(**pgon, query)) {
+                    ++bruteBlocked;
+                    break;
+                }
+            }
+        }
+        clock_t bruteTime = clock() - bruteStart;
+        
+        outputFile << "PointLocation: " << indexTime << " "
+                   << pointIndex.cellsPerSide * pointIndex.cellsPerSide << " "
+                   << pointLocationMemory(pointIndex) << " " << POINTQUERIES
+                   << " " << blocked << " " << queryTime << " "
+                   << bruteBlocked << " " << bruteTime << endl;
+    }
+    
+    // Optional space-filling curve renumbering (see README). Must come before
+    // anything else is built from ownerGraph.
+    if (VERTEXORDER != FILE_ORDER) {
+        clock_t reorderStart = clock();
+        int reorderCounter = 0;
+        reorderVertices(ownerGraph, VERTEXORDER, reorderCounter);
+        outputFile << "Reorder: " << clock() - reorderStart << endl;
+    }
+    
+    // Optional landmark preprocessing (see README)
+    Landmarks landmarks;
+    if (NUMOFLANDMARKS > 0) {
+        clock_t landmarksStart = clock();
+        int landmarksCounter = 0;
+        selectLandmarks(ownerGraph, NUMOFLANDMARKS, landmarks,
+                        landmarksCounter);
+        outputFile << "Landmarks: " << landmarks.landmarkVertices.size() << " "
+                   << landmarksMemory(landmarks) << " "
+                   << clock() - landmarksStart << endl;
+    }
+    
+    // Optional contraction hierarchy (see README)
+    ContractionHierarchy hierarchy;
+    if (USECONTRACTION) {
+        clock_t contractionStart = clock();
+        int contractionCounter = 0;
+        buildContractionHierarchy(ownerGraph, hierarchy, contractionCounter);
+        outputFile << "Contraction: " << hierarchy.numShortcuts << " "
+                   << clock() - contractionStart << endl;
+    }
+    
+    // Optional all-pairs distance oracle (see README)
+    DistanceOracle oracle;
+    if (ORACLEMEMORYLIMIT > 0) {
+        clock_t oracleStart = clock();
+        int oracleCounter = 0;
+        buildDistanceOracle(ownerGraph, ORACLEMEMORYLIMIT, oracle,
+                            oracleCounter);
+        outputFile << "Oracle: " << oracle.built << " "
+                   << oracleMemory(ownerGraph.vertices.size()) << " "
+                   << clock() - oracleStart << endl;
+    }
+    
+    // Optional hierarchical tiled graph (see README)
+    TiledGraph tiled;
+    if (TILESPERSIDE > 0) {
+        clock_t tilesStart = clock();
+        buildTiledGraph(polygons, -100, 100, TILESPERSIDE, PORTALSPERBORDER,
+                        TILETHREADS, tiled);
+        clock_t tilesTime = clock() - tilesStart;
+        // Rebuilding one tile, as after a change to its obstacles
+        clock_t rebuildStart = clock();
+        rebuildTile(tiled, polygons, 0);
+        outputFile << "Tiles: " << tiled.tiles.size() << " "
+                   << tiled.portals.size() << " " << tilesTime << " "
+                   << clock() - rebuildStart << endl;
+    }
+    
+    // Optional out-of-core build (see README)
+    MappedGraph mappedGraph;
+    if (STREAMINGBUDGET > 0) {
+        clock_t streamingStart = clock();
+        StreamingStats streamingStats;
+        int streamingCounter = 0;
+        if (!streamingBuild(polygons, "streamed_graph.bin", STREAMINGBUDGET,
+                            streamingStats, streamingCounter) ||
+            !mappedGraph.open("streamed_graph.bin")) {
+            cout << "Error writing file: streamed_graph.bin" << endl;
+            assert(false);
+        }
+        outputFile << "Streaming: " << streamingStats.numEdges << " "
+                   << streamingStats.numRuns << " "
+                   << streamingStats.peakBufferBytes << " "
+                   << clock() - streamingStart << endl;
+    }
+    
+    // Optional simplified graph (see README), built from the same polygons
+    Graph simplifiedGraph;
+    List<List<Vertex>> simplifiedPolygons(true);
+    if (SIMPLIFYTOLERANCE > 0) {
+        clock_t simplifyStart = clock();
+        int dummyCounter = 0;
+        generator.toPolygons(simplifiedPolygons, dummyCounter);
+        int removedVertices = simplifyPolygons(simplifiedPolygons,
+                                               SIMPLIFYTOLERANCE,
+                                               dummyCounter);
+        addVertices(simplifiedGraph, simplifiedPolygons, dummyCounter);
+        makeConnections(simplifiedGraph, simplifiedPolygons, dummyCounter,
+                        dummyCounter, dummyCounter);
+        outputFile << "Simplified: " << simplifiedGraph.vertices.size() << " "
+                   << simplifiedGraph.connections.size() << " "
+                   << clock() - simplifyStart << " " << removedVertices
+                   << endl;
+    }
+    
+    // Optional incremental update check (see README)
+    if (INCREMENTALTEST) {
+        // Updates are made to a rebuilt copy so the searches below use the
+        // original graph
+        int dummyCounter = 0;
+        stringstream allPolygons;
+        allPolygons.precision(20);
+        writePolygons(allPolygons, polygons);
+        Graph updatedGraph;
+        List<List<Vertex>> updatedPolygons(true);
+        preProcess(updatedGraph, allPolygons, updatedPolygons, dummyCounter,
+                   dummyCounter, dummyCounter, dummyCounter, dummyCounter);
+        
+        // Keep a copy of the polygon to put it back afterward
+        const int removedIndex = rand() % numOfPolygons;
+        List<Vertex> *removedPolygon = new List<Vertex>(true);
+        List<Vertex>::Iterator endV = polygons.at(removedIndex)->end();
+        for (List<Vertex>::Iterator v = polygons.at(removedIndex)->begin();
+             v != endV; ++v) {
+            Vertex *copy = new Vertex;
+            *copy = **v;
+            removedPolygon->insertEnd(copy);
+        }
+        
+        clock_t removeStart = clock();
+        removePolygon(updatedGraph, updatedPolygons, removedIndex,
+                      dummyCounter);
+        clock_t removeTime = clock() - removeStart;
+        
+        // Full rebuild without the polygon
+        stringstream remainingPolygons;
+        remainingPolygons.precision(20);
+        writePolygons(remainingPolygons, updatedPolygons);
+        Graph rebuiltGraph;
+        List<List<Vertex>> rebuiltPolygons(true);
+        preProcess(rebuiltGraph, remainingPolygons, rebuiltPolygons,
+                   dummyCounter, dummyCounter, dummyCounter, dummyCounter,
+                   dummyCounter);
+        bool removeMatches = sameVisibilityGraph(updatedGraph, rebuiltGraph);
+        
+        clock_t addStart = clock();
+        addPolygon(updatedGraph, updatedPolygons, removedPolygon,
+                   dummyCounter);
+        clock_t addTime = clock() - addStart;
+        bool addMatches = sameVisibilityGraph(updatedGraph, ownerGraph);
+        
+        outputFile << "Incremental: " << removeTime << " " << addTime << " "
+                   << removeMatches << " " << addMatches << endl;
+    }
+    
+    // Optional D* Lite replanning comparison (see README). Uses the first
+    // search that needs the graph.
+    int replanSearch = 0;
+    if (DSTARREPLANS > 0) {
+        int dummyCounter = 0;
+        while (replanSearch < NUMOFSEARCHES &&
+               visible(startPoints[replanSearch], endPoints[replanSearch],
+                       polygons, dummyCounter)) {
+            ++replanSearch;
+        }
+    }
+    if (DSTARREPLANS > 0 && replanSearch < NUMOFSEARCHES) {
+        // The map changes on a rebuilt copy that owns its start and goal
+        int dummyCounter = 0;
+        stringstream allPolygons;
+        allPolygons.precision(20);
+        writePolygons(allPolygons, polygons);
+        Graph dynamicGraph;
+        List<List<Vertex>> dynamicPolygons(true);
+        preProcess(dynamicGraph, allPolygons, dynamicPolygons, dummyCounter,
+                   dummyCounter, dummyCounter, dummyCounter, dummyCounter);
+        
+        Vertex *start = new Vertex;
+        *start = startPoints[replanSearch];
+        Vertex *goal = new Vertex;
+        *goal = endPoints[replanSearch];
+        dynamicGraph.vertices.insertStart(goal);
+        dynamicGraph.vertices.insertStart(start);
+        List<Vertex>::Iterator it_start = dynamicGraph.vertices.begin();
+        List<Vertex>::Iterator it_goal = it_start;
+        ++it_goal;
+        visibleVertices(it_start, dynamicGraph, dynamicPolygons, dummyCounter,
+                        dummyCounter);
+        visibleVertices(it_goal, dynamicGraph, dynamicPolygons, dummyCounter,
+                        dummyCounter);
+        
+        State goalState = {goal};
+        DStarLite planner(dynamicGraph, State{start}, goalState);
+        vector<State> plannerSolution;
+        // Polygon taken out by the last update (put back by the next one)
+        List<Vertex> *removedPolygon = nullptr;
+        
+        // Where the vehicle is
+        State current = {start};
+        
+        // Replan 0 is the initial plan, each later one follows a map update
+        for (int replan = 0; replan <= DSTARREPLANS; ++replan) {
+            if (replan > 0) {
+                // Move one step along the last path (not onto the goal)
+                if (plannerSolution.size() > 2) {
+                    current = plannerSolution[plannerSolution.size() - 2];
+                }
+                
+                GraphEdges before;
+                recordEdges(dynamicGraph, before);
+                if (removedPolygon == nullptr) {
+                    // Take out a random polygon the vehicle is not on
+                    int offset = rand() % dynamicPolygons.size();
+                    for (int i = 0; i < dynamicPolygons.size(); ++i) {
+                        List<Vertex> *pgon = dynamicPolygons.at(
+                            (offset + i) % dynamicPolygons.size());
+                        int pgonIndex = (*pgon->begin())->polygon;
+                        if (pgonIndex == current.position->polygon) {
+                            continue;
+                        }
+                        removedPolygon = new List<Vertex>(true);
+                        List<Vertex>::Iterator endV = pgon->end();
+                        for (List<Vertex>::Iterator v = pgon->begin();
+                             v != endV; ++v) {
+                            Vertex *copy = new Vertex;
+                            *copy = **v;
+                            removedPolygon->insertEnd(copy);
+                        }
+                        removePolygon(dynamicGraph, dynamicPolygons,
+                                      pgonIndex, dummyCounter);
+                        break;
+                    }
+                } else {
+                    addPolygon(dynamicGraph, dynamicPolygons, removedPolygon,
+                               dummyCounter);
+                    removedPolygon = nullptr;
+                }
+                
+                vector<Edge> changes;
+                vector<const Vertex*> removedVertices;
+                diffEdges(before, dynamicGraph, changes, removedVertices);
+                planner.moveStart(current);
+                planner.updateEdges(changes, removedVertices);
+            }
+            
+            plannerSolution.clear();
+            int plannerNodesExpanded = 0;
+            double plannerDistance = planner.plan(plannerSolution,
+                                                  plannerNodesExpanded);
+            
+            Problem coldProb(dynamicGraph, current, goalState);
+            vector<State> coldSolution;
+            int coldNodesExpanded = 0;
+            int maxTreeSize = 0;
+            size_t memoryUse = 0;
+            double coldDistance = AStarSearch(coldProb, coldSolution,
+                                              coldNodesExpanded, maxTreeSize,
+                                              memoryUse);
+            outputFile << "Replan: " << plannerNodesExpanded << " "
+                       << coldNodesExpanded << " " << plannerDistance << " "
+                       << coldDistance << endl;
+        }
+        delete removedPolygon;
+    }
+    
+    // Optional snapshot stress benchmark (see README): readers query while
+    // rebuilt snapshots (alternately without and with the first polygon) are
+    // published
+    if (SNAPSHOTREADERS > 0) {
+        stringstream allPolygons;
+        allPolygons.precision(20);
+        writePolygons(allPolygons, polygons);
+        const string withAll = allPolygons.str();
+        // The first polygon takes up the first two lines
+        const string withoutFirst =
+            withAll.substr(withAll.find('\n', withAll.find('\n') + 1) + 1);
+        
+        stringstream initialPolygons(withAll);
+        SnapshotRegistry registry(buildSnapshot(initialPolygons, 0));
+        vector<weak_ptr<const GraphSnapshot>> published;
+        published.push_back(registry.pin());
+        
+        atomic<bool> stop(false);
+        vector<ReaderStats> stats(SNAPSHOTREADERS);
+        vector<thread> readers;
+        for (int i = 0; i < SNAPSHOTREADERS; ++i) {
+            readers.push_back(thread(snapshotReader, cref(registry),
+                                     startPoints, endPoints, cref(stop),
+                                     ref(stats[i])));
+        }
+        
+        for (int version = 1; version <= SNAPSHOTSWAPS; ++version) {
+            stringstream nextPolygons(version % 2 == 1 ? withoutFirst
+                                                       : withAll);
+            shared_ptr<const GraphSnapshot> next =
+                buildSnapshot(nextPolygons, version);
+            published.push_back(next);
+            registry.publish(next);
+        }
+        // Let the readers run on the last snapshot as well
+        this_thread::sleep_for(chrono::milliseconds(100));
+        stop = true;
+        for (int i = 0; i < SNAPSHOTREADERS; ++i) {
+            readers[i].join();
+        }
+        
+        ReaderStats total = {0, 0, 0, 0, 0};
+        for (int i = 0; i < SNAPSHOTREADERS; ++i) {
+            total.queries += stats[i].queries;
+            total.totalMicros += stats[i].totalMicros;
+            total.maxMicros = max(total.maxMicros, stats[i].maxMicros);
+            total.swapQueries += stats[i].swapQueries;
+            total.swapMicros += stats[i].swapMicros;
+        }
+        // Only the current snapshot should still be alive
+        int alive = 0;
+        for (int i = 0; i < (int) published.size(); ++i) {
+            alive += !published[i].expired();
+        }
+        outputFile << "Snapshots: " << total.queries << " "
+                   << total.totalMicros / max(total.queries, 1) << " "
+                   << total.maxMicros << " " << total.swapQueries << " "
+                   << total.swapMicros / max(total.swapQueries, 1) << " "
+                   << alive << endl;
+    }
+    outputFile << endl;
+    
+    // Number of searches stopped by SEARCHTIMEBUDGET or SEARCHEXPANSIONBUDGET
+    int budgetHits = 0;
+    
+    // Solution of the SearchContext queries, reused like the context
+    vector<State> contextSolution;
     
     // Run each Search
     for (int search = 0; search < NUMOFSEARCHES; ++search) {
+        TraceScope searchTrace("search", search);
         // Copy-construct a new graph (won't own data, but that's ok)
         Graph searchGraph(ownerGraph);
         // This list will ensure deletion of any newly-created edges for
@@ -427,11 +1010,16 @@ void runTest(int testIndex, ostream &polygonFile, ostream &outputFile) {
         int dummyCounter2 = 0;
         if (visible(*start, *goal, polygons, dummyCounter)) {
             // No need for A*, output everything now
+            TraceScope outputTrace("write results");
             solution.push_back(goalState);
             solution.push_back(startState);
             prob.printSolution(solution, outputFile);
-            outputFile << distanceFormula(*start, *goal, DIMENSIONS) << endl
+            outputFile << distanceFormula(*start, *goal) << endl
                        << endl;
+            SearchRecord searchRecord = {testIndex, search, 1, 1,
+                                         distanceFormula(*start, *goal),
+                                         0, 0, 0, 0, 0, 0};
+            writeSearchRecord(resultsFile, searchRecord);
         } else {
             // Add start and goal to graph
             searchGraph.vertices.insertStart(goal);
@@ -440,10 +1028,13 @@ void runTest(int testIndex, ostream &polygonFile, ostream &outputFile) {
             List<Vertex>::Iterator it_start = searchGraph.vertices.begin();
             List<Vertex>::Iterator it_goal = it_start;
             ++it_goal;
-            visibleVertices(it_start, searchGraph, polygons, dummyCounter,
-                            dummyCounter2, victims);
-            visibleVertices(it_goal, searchGraph, polygons, dummyCounter,
-                            dummyCounter2, victims);
+            {
+                TraceScope attachTrace("attach start and goal");
+                visibleVertices(it_start, searchGraph, polygons, dummyCounter,
+                                dummyCounter2, victims);
+                visibleVertices(it_goal, searchGraph, polygons, dummyCounter,
+                                dummyCounter2, victims);
+            }
             // Now, start and goal should be properly inserted in the graph
         
             // Start the clock for A*
@@ -453,22 +1044,262 @@ void runTest(int testIndex, ostream &polygonFile, ostream &outputFile) {
             int nodesExpandedCounter = 0;
             int maxTreeSize = 0;
             size_t memoryUse = 0;
-            double distance = AStarSearch(prob, solution, nodesExpandedCounter,
-                                          maxTreeSize, memoryUse);
+            SearchBudget budget = {chrono::steady_clock::time_point(),
+                                   SEARCHEXPANSIONBUDGET, nullptr};
+            if (SEARCHTIMEBUDGET > 0) {
+                budget.deadline =
+                    chrono::steady_clock::now() +
+                    chrono::duration_cast<chrono::steady_clock::duration>(
+                        chrono::duration<double>(SEARCHTIMEBUDGET));
+            }
+            double distance = -1;
+            perf.start();
+            SearchStatus status =
+                budgetedAStarSearch(prob, budget, solution, distance,
+                                    nodesExpandedCounter, maxTreeSize,
+                                    memoryUse);
+            PerfSample searchPerf = perf.stop();
             
             // Stop the clock for A*
             clock_t AStarTime = clock() - AStarStart;
             
+            // A best-effort path is not a solution, report it as a failure
+            if (status == SEARCH_BUDGET_HIT) {
+                ++budgetHits;
+                solution.clear();
+                distance = -1;
+            }
+            
             // Output to file
-            prob.printSolution(solution, outputFile);
-            outputFile << distance << endl;
-            outputFile << searchGraph.vertices.size() << " "
-                       << searchGraph.connections.size() << endl;
-            outputFile << nodesExpandedCounter << " " << AStarTime << endl;
-            outputFile << maxTreeSize << " " << memoryUse << endl << endl;
+            {
+                TraceScope outputTrace("write results");
+                prob.printSolution(solution, outputFile);
+                outputFile << distance << endl;
+                outputFile << searchGraph.vertices.size() << " "
+                           << searchGraph.connections.size() << endl;
+                outputFile << nodesExpandedCounter << " " << AStarTime
+                           << endl;
+                outputFile << maxTreeSize << " " << memoryUse << endl;
+                if (PERFCOUNTERS) {
+                    outputFile << "Perf: ";
+                    printPerfSample(outputFile, searchPerf);
+                    outputFile << endl;
+                }
+                SearchRecord searchRecord = {testIndex, search,
+                                             !solution.empty(), 0, distance,
+                                             searchGraph.vertices.size(),
+                                             searchGraph.connections.size(),
+                                             nodesExpandedCounter,
+                                             (long) AStarTime, maxTreeSize,
+                                             memoryUse};
+                writeSearchRecord(resultsFile, searchRecord);
+            }
+            
+            // Repeat the search with the landmark heuristic
+            if (NUMOFLANDMARKS > 0) {
+                Problem landmarkProb(searchGraph, startState, goalState);
+                landmarkProb.useLandmarks(landmarks);
+                vector<State> landmarkSolution;
+                int landmarkNodesExpanded = 0;
+                clock_t landmarkStart = clock();
+                AStarSearch(landmarkProb, landmarkSolution,
+                            landmarkNodesExpanded, maxTreeSize, memoryUse);
+                outputFile << "Landmarks: " << landmarkNodesExpanded << " "
+                           << clock() - landmarkStart << endl;
+            }
+            
+            // Repeat the search on the contraction hierarchy
+            if (USECONTRACTION) {
+                vector<State> contractionSolution;
+                int nodesSettled = 0;
+                clock_t contractionStart = clock();
+                double contractionDistance =
+                    contractionSearch(hierarchy, victims, startState,
+                                      goalState, contractionSolution,
+                                      nodesSettled);
+                clock_t contractionTime = clock() - contractionStart;
+                // The unpacked path must follow edges of the graph and add
+                // up to the distance the hierarchy reported
+                double unpackedLength = graphPathLength(searchGraph,
+                                                        contractionSolution);
+                bool validPath = contractionDistance < 0 ?
+                    contractionSolution.empty() :
+                    fabs(unpackedLength - contractionDistance) <=
+                    1e-9 * max(1.0, contractionDistance);
+                outputFile << "Contraction: " << nodesSettled << " "
+                           << contractionTime << " " << contractionDistance
+                           << " " << validPath << endl;
+            }
+            
+            // Repeat the query with the distance oracle (falls back to A* if
+            // the tables did not fit)
+            if (ORACLEMEMORYLIMIT > 0) {
+                vector<State> oracleSolution;
+                int oracleNodesExpanded = 0;
+                clock_t oracleStart = clock();
+                double oracleDistance =
+                    oracleOrAStarSearch(oracle, prob, victims, startState,
+                                        goalState, oracleSolution,
+                                        oracleNodesExpanded, maxTreeSize,
+                                        memoryUse);
+                outputFile << "Oracle: " << clock() - oracleStart << " "
+                           << oracleDistance << endl;
+            }
+            
+            // Repeat the query on the tiled graph
+            if (TILESPERSIDE > 0) {
+                vector<State> tiledSolution;
+                int portalsSettled = 0;
+                clock_t tiledStart = clock();
+                double tiledDistance = tiledSearch(tiled, start, goal,
+                                                   tiledSolution,
+                                                   portalsSettled);
+                outputFile << "Tiled: " << portalsSettled << " "
+                           << clock() - tiledStart << " " << tiledDistance
+                           << endl;
+            }
+            
+            // Repeat the search on the memory-mapped graph
+            if (STREAMINGBUDGET > 0) {
+                vector<State> mappedSolution;
+                int mappedNodesExpanded = 0;
+                clock_t mappedStart = clock();
+                double mappedDistance = mappedSearch(mappedGraph, polygons,
+                                                     start, goal,
+                                                     mappedSolution,
+                                                     mappedNodesExpanded);
+                outputFile << "Mapped: " << mappedNodesExpanded << " "
+                           << clock() - mappedStart << " " << mappedDistance
+                           << endl;
+            }
+            
+            // Repeat the search on the simplified graph. The grown polygons
+            // can swallow start or goal, which is reported as a failure.
+            if (SIMPLIFYTOLERANCE > 0) {
+                bool blocked = false;
+                List<List<Vertex>>::Iterator endP = simplifiedPolygons.end();
+                for (List<List<Vertex>>::Iterator pgon =
+                         simplifiedPolygons.begin();
+                     pgon != endP && !blocked; ++pgon) {
+                    blocked = insideConvexPolygon(**pgon, *start) ||
+                              insideConvexPolygon(**pgon, *goal);
+                }
+                
+                Graph simplifiedSearchGraph(simplifiedGraph);
+                List<Edge> simplifiedVictims(true);
+                vector<State> simplifiedSolution;
+                int simplifiedNodesExpanded = 0;
+                double simplifiedDistance = -1;
+                clock_t simplifiedStart = clock();
+                if (blocked) {
+                    // Leave the failure
+                } else if (visible(*start, *goal, simplifiedPolygons,
+                                   dummyCounter)) {
+                    simplifiedDistance = distanceFormula(*start, *goal);
+                } else {
+                    simplifiedSearchGraph.vertices.insertStart(goal);
+                    simplifiedSearchGraph.vertices.insertStart(start);
+                    List<Vertex>::Iterator it_simplifiedStart =
+                        simplifiedSearchGraph.vertices.begin();
+                    List<Vertex>::Iterator it_simplifiedGoal =
+                        it_simplifiedStart;
+                    ++it_simplifiedGoal;
+                    visibleVertices(it_simplifiedStart, simplifiedSearchGraph,
+                                    simplifiedPolygons, dummyCounter,
+                                    dummyCounter2, simplifiedVictims);
+                    visibleVertices(it_simplifiedGoal, simplifiedSearchGraph,
+                                    simplifiedPolygons, dummyCounter,
+                                    dummyCounter2, simplifiedVictims);
+                    Problem simplifiedProb(simplifiedSearchGraph, startState,
+                                           goalState);
+                    int simplifiedTreeSize = 0;
+                    size_t simplifiedMemory = 0;
+                    simplifiedDistance =
+                        AStarSearch(simplifiedProb, simplifiedSolution,
+                                    simplifiedNodesExpanded,
+                                    simplifiedTreeSize, simplifiedMemory);
+                }
+                outputFile << "Simplified: " << simplifiedNodesExpanded << " "
+                           << clock() - simplifiedStart << " "
+                           << simplifiedDistance << endl;
+            }
+            
+            // Repeat the search with the policy-based engine: first on the
+            // same Problem callbacks as AStarSearch, then on an indexed copy
+            // of the graph whose callbacks inline
+            if (POLICYBENCHMARK) {
+                ProblemAdapter adaptedProb(prob, startState, goalState);
+                clock_t adjacencyStart = clock();
+                AdjacencyGraph searchAdjacency;
+                buildAdjacency(searchGraph, searchAdjacency);
+                AdjacencyProblem indexedProb(searchAdjacency, start, goal);
+                outputFile << "Policies: " << clock() - adjacencyStart;
+                timePolicies<SortedListOpen, VectorClosedSet,
+                             HashNodeStorage>(adaptedProb, outputFile);
+                timePolicies<BinaryHeapOpen, HashClosedSet,
+                             HashNodeStorage>(adaptedProb, outputFile);
+                timePolicies<SortedListOpen, VectorClosedSet,
+                             HashNodeStorage>(indexedProb, outputFile);
+                timePolicies<BinaryHeapOpen, HashClosedSet,
+                             HashNodeStorage>(indexedProb, outputFile);
+                timePolicies<BinaryHeapOpen, NodeFlagClosedSet,
+                             IndexedNodeStorage>(indexedProb, outputFile);
+                timePolicies<QuaternaryHeapOpen, NodeFlagClosedSet,
+                             IndexedNodeStorage>(indexedProb, outputFile);
+                outputFile << endl;
+            }
+            
+            // Repeat the search with an inflated heuristic
+            if (SEARCHINFLATION > 1) {
+                vector<State> weightedSolution;
+                int weightedNodesExpanded = 0;
+                clock_t weightedStart = clock();
+                double weightedDistance =
+                    AStarSearch(prob, weightedSolution, weightedNodesExpanded,
+                                maxTreeSize, memoryUse, SEARCHINFLATION);
+                outputFile << "Weighted: " << weightedNodesExpanded << " "
+                           << clock() - weightedStart << " "
+                           << weightedDistance << endl;
+            }
+            
+            // Repeat the search in anytime mode
+            if (ANYTIMEBUDGET > 0) {
+                vector<AnytimeSolution> anytimeSolutions;
+                anytimeSearch(prob, ANYTIMEEPSILON, ANYTIMESTEP, ANYTIMEBUDGET,
+                              anytimeSolutions);
+                outputFile << "Anytime: " << anytimeSolutions.size();
+                for (int i = 0; i < (int) anytimeSolutions.size(); ++i) {
+                    outputFile << " " << anytimeSolutions[i].cost << " "
+                               << anytimeSolutions[i].bound << " "
+                               << anytimeSolutions[i].time;
+                }
+                outputFile << endl;
+            }
+            
+            // Repeat the search with the thread's reusable buffers
+            if (REUSESEARCHCONTEXT) {
+                SearchContext &context = threadSearchContext();
+                int contextNodesExpanded = 0;
+                int contextNodes = 0;
+                contextSolution.clear();
+                clock_t contextStart = clock();
+                double contextDistance =
+                    context.search(prob, contextSolution,
+                                   contextNodesExpanded, contextNodes);
+                clock_t contextTime = clock() - contextStart;
+                
+                outputFile << "Context: " << contextNodesExpanded << " "
+                           << contextTime << " " << contextDistance << " "
+                           << context.memory() << endl;
+            }
+            outputFile << endl;
         }
     }
     
+    if (SEARCHTIMEBUDGET > 0 || SEARCHEXPANSIONBUDGET > 0) {
+        outputFile << "Budget_Hits: " << budgetHits << endl;
+    }
+    
     // Print newline before next test
     outputFile << endl;
 }
@@ -0,0 +1,199 @@
+//
+//  map_generator.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include "map_generator.h"
+#include "trace.h"
+
+using namespace std;
+
+static const double PI = 3.14159265358979323846;
+
+// REQUIRES: halfWidth > 0
+// EFFECTS : Constructs a generator for maps over the square from
+//           (-halfWidth, -halfWidth) to (halfWidth, halfWidth), seeded
+//           with seed
+MapGenerator::MapGenerator(unsigned seed, double halfWidth)
+: engine(seed), halfWidth(halfWidth), maxRadius(halfWidth), cellsPerSide(1),
+  cellWidth(2 * halfWidth), cells(1), polygonStart(1, 0), attempts(0) {
+    assert(halfWidth > 0);
+}
+
+// EFFECTS : Returns the grid cell along one axis of coordinate value
+int MapGenerator::cellOf(double value) const {
+    int cell = (int) ((value + halfWidth) / cellWidth);
+    return max(0, min(cellsPerSide - 1, cell));
+}
+
+// EFFECTS : Returns the distance from (x, y) to the nearest circle
+//           boundary, up to maxRadius (negative if (x, y) is inside a
+//           circle)
+double MapGenerator::circleClearance(double x, double y) const {
+    double result = maxRadius;
+    // Cells are at least twice as wide as the largest circle, so a circle
+    // whose center is not in a neighboring cell is at least maxRadius away
+    int cellX = cellOf(x);
+    int cellY = cellOf(y);
+    for (int j = max(0, cellY - 1); j <= min(cellsPerSide - 1, cellY + 1);
+         ++j) {
+        for (int i = max(0, cellX - 1); i <= min(cellsPerSide - 1, cellX + 1);
+             ++i) {
+            for (int circle : cells[j * cellsPerSide + i]) {
+                double distance = hypot(x - centers[2 * circle],
+                                        y - centers[2 * circle + 1]) -
+                                  radii[circle];
+                result = min(result, distance);
+            }
+        }
+    }
+    return result;
+}
+
+// EFFECTS : Returns the distance from (x, y) to the nearest circle
+//           boundary or map edge, up to maxRadius (negative if (x, y) is
+//           inside a circle or outside the map)
+double MapGenerator::clearance(double x, double y) const {
+    return min(circleClearance(x, y), min(halfWidth - fabs(x),
+                                          halfWidth - fabs(y)));
+}
+
+// REQUIRES: numPolygons > 0, maxVertices >= 3
+// MODIFIES: this
+// EFFECTS : Replaces the map with numPolygons polygons. Each gets a random
+//           center outside every earlier circle and a random radius up to
+//           the distance to the nearest circle or map edge, capped at
+//           halfWidth / sqrt(numPolygons), and 3 to maxVertices corners
+//           at random angles on its circle, in counterclockwise order.
+//           Stops early if maxAttempts centers in a row land inside
+//           circles. Returns the number of polygons placed.
+int MapGenerator::generate(int numPolygons, int maxVertices,
+                           int maxAttempts) {
+    TraceScope trace("generate map");
+    assert(numPolygons > 0 && maxVertices >= 3);
+
+    // Cells twice as wide as the largest circle
+    maxRadius = halfWidth / sqrt((double) numPolygons);
+    cellsPerSide = max(1, (int) floor(halfWidth / maxRadius));
+    cellWidth = 2 * halfWidth / cellsPerSide;
+    cells.assign(cellsPerSide * cellsPerSide, vector<int>());
+    centers.clear();
+    radii.clear();
+    corners.clear();
+    polygonStart.assign(1, 0);
+    attempts = 0;
+
+    uniform_real_distribution<double> coordinate(-halfWidth, halfWidth);
+    uniform_real_distribution<double> unit(0, 1);
+    uniform_real_distribution<double> angle(0, 2 * PI);
+    uniform_int_distribution<int> vertexCount(3, maxVertices);
+    vector<double> angles;
+
+    int failures = 0;
+    while ((int) radii.size() < numPolygons && failures < maxAttempts) {
+        double x = coordinate(engine);
+        double y = coordinate(engine);
+        ++attempts;
+        double upperBoundRadius = clearance(x, y);
+        if (upperBoundRadius <= 0) {
+            ++failures;
+            continue;
+        }
+        failures = 0;
+
+        double radius = unit(engine) * upperBoundRadius;
+        int circle = (int) radii.size();
+        centers.push_back(x);
+        centers.push_back(y);
+        radii.push_back(radius);
+        cells[cellOf(y) * cellsPerSide + cellOf(x)].push_back(circle);
+
+        // Corners at sorted random angles are in counterclockwise order
+        angles.resize(vertexCount(engine));
+        for (double &a : angles) {
+            a = angle(engine);
+        }
+        sort(angles.begin(), angles.end());
+        for (double a : angles) {
+            corners.push_back(x + radius * cos(a));
+            corners.push_back(y + radius * sin(a));
+        }
+        polygonStart.push_back((int) corners.size() / 2);
+    }
+    return (int) radii.size();
+}
+
+// EFFECTS : Returns the number of polygons in the map
+int MapGenerator::numPolygons() const {
+    return (int) radii.size();
+}
+
+// EFFECTS : Returns the number of polygon corners in the map
+int MapGenerator::numVertices() const {
+    return (int) corners.size() / 2;
+}
+
+// EFFECTS : Returns the number of centers drawn by the last generate,
+//           including rejected ones
+long long MapGenerator::centerAttempts() const {
+    return attempts;
+}
+
+// EFFECTS : Returns a random point that is outside every circle (and so
+//           outside every polygon), snapped (see snapToGrid)
+Vertex MapGenerator::freePoint() {
+    static_assert(DIMENSIONS == 2, "maps are generated in the plane");
+    uniform_real_distribution<double> coordinate(-halfWidth, halfWidth);
+    while (true) {
+        Vertex point = {{coordinate(engine), coordinate(engine)}, -1, -1, -1};
+        snapToGrid(point);
+        if (circleClearance(point.coord[0], point.coord[1]) > 0) {
+            return point;
+        }
+    }
+}
+
+// MODIFIES: os
+// EFFECTS : Writes the polygons to os in the polygon file format (see
+//           read_polygons), at os's precision
+void MapGenerator::write(std::ostream &os) const {
+    for (int p = 0; p < numPolygons(); ++p) {
+        os << polygonStart[p + 1] - polygonStart[p] << endl;
+        for (int c = polygonStart[p]; c < polygonStart[p + 1]; ++c) {
+            os << corners[2 * c] << " " << corners[2 * c + 1] << " ";
+        }
+        os << endl;
+    }
+}
+
+// REQUIRES: polygons is empty
+// MODIFIES: polygons, loopCounter
+// EFFECTS : Fills polygons with the map's polygons as read_polygons would
+//           read them from a file write produced at full precision, without
+//           the text round trip. Adds one loop per vertex to loopCounter, as
+//           read_polygons does.
+void MapGenerator::toPolygons(List<List<Vertex>> &polygons,
+                              int &loopCounter) const {
+    assert(polygons.empty());
+    for (int p = 0; p < numPolygons(); ++p) {
+        const int size = polygonStart[p + 1] - polygonStart[p];
+        List<Vertex> *polygon = new List<Vertex>(true);
+        for (int i = 0; i < size; ++i) {
+            int c = polygonStart[p] + i;
+            Vertex *v = new Vertex();
+            v->coord[0] = corners[2 * c];
+            v->coord[1] = corners[2 * c + 1];
+            snapToGrid(*v);
+            v->polygon = p;
+            v->location = i;
+            v->poly_size = size;
+            polygon->insertEnd(v);
+            
+            ++loopCounter;
+        }
+        polygons.insertEnd(polygon);
+    }
+}
@@ -0,0 +1,108 @@
+//
+//  map_generator.h
+//  Visibility Graph Path Planning
+//
+//  Random obstacle maps for benchmarking. Each polygon is inscribed in a
+//  circle that must not overlap any circle placed before it, which keeps the
+//  polygons convex and disjoint. Checking a new circle against every earlier
+//  one makes generation quadratic, so circles are bucketed in a uniform grid
+//  with cells twice as wide as the largest circle: only the circles in the
+//  surrounding cells can touch a new one. Radii are capped by the number of
+//  polygons so the plane does not fill up, and all randomness comes from a
+//  seeded engine, so a seed always gives the same map.
+//
+
+#ifndef map_generator_h
+#define map_generator_h
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include "preprocessing.h"
+
+class MapGenerator {
+private:
+    std::mt19937 engine;
+    // Maps cover the square from (-halfWidth, -halfWidth) to
+    // (halfWidth, halfWidth)
+    double halfWidth;
+    // Largest radius of a circle
+    double maxRadius;
+
+    // Circles the polygons are inscribed in
+    std::vector<double> centers;
+    std::vector<double> radii;
+    // Grid of circle indices by center, cellsPerSide cells along each axis,
+    // each at least twice as wide as the largest circle
+    int cellsPerSide;
+    double cellWidth;
+    std::vector<std::vector<int>> cells;
+
+    // Polygon corners as (x, y) pairs, back to back; polygon p runs from
+    // corner polygonStart[p] to corner polygonStart[p + 1] - 1
+    std::vector<double> corners;
+    std::vector<int> polygonStart;
+
+    // Centers drawn, including the ones that landed inside a circle
+    long long attempts;
+
+    // EFFECTS : Returns the grid cell along one axis of coordinate value
+    int cellOf(double value) const;
+
+    // EFFECTS : Returns the distance from (x, y) to the nearest circle
+    //           boundary, up to maxRadius (negative if (x, y) is inside a
+    //           circle)
+    double circleClearance(double x, double y) const;
+
+    // EFFECTS : Returns the distance from (x, y) to the nearest circle
+    //           boundary or map edge, up to maxRadius (negative if (x, y) is
+    //           inside a circle or outside the map)
+    double clearance(double x, double y) const;
+
+public:
+    // REQUIRES: halfWidth > 0
+    // EFFECTS : Constructs a generator for maps over the square from
+    //           (-halfWidth, -halfWidth) to (halfWidth, halfWidth), seeded
+    //           with seed
+    MapGenerator(unsigned seed, double halfWidth);
+
+    // REQUIRES: numPolygons > 0, maxVertices >= 3
+    // MODIFIES: this
+    // EFFECTS : Replaces the map with numPolygons polygons. Each gets a random
+    //           center outside every earlier circle and a random radius up to
+    //           the distance to the nearest circle or map edge, capped at
+    //           halfWidth / sqrt(numPolygons), and 3 to maxVertices corners
+    //           at random angles on its circle, in counterclockwise order.
+    //           Stops early if maxAttempts centers in a row land inside
+    //           circles. Returns the number of polygons placed.
+    int generate(int numPolygons, int maxVertices, int maxAttempts);
+
+    // EFFECTS : Returns the number of polygons in the map
+    int numPolygons() const;
+
+    // EFFECTS : Returns the number of polygon corners in the map
+    int numVertices() const;
+
+    // EFFECTS : Returns the number of centers drawn by the last generate,
+    //           including rejected ones
+    long long centerAttempts() const;
+
+    // EFFECTS : Returns a random point that is outside every circle (and so
+    //           outside every polygon), snapped (see snapToGrid)
+    Vertex freePoint();
+
+    // MODIFIES: os
+    // EFFECTS : Writes the polygons to os in the polygon file format (see
+    //           read_polygons), at os's precision
+    void write(std::ostream &os) const;
+
+    // REQUIRES: polygons is empty
+    // MODIFIES: polygons, loopCounter
+    // EFFECTS : Fills polygons with the map's polygons as read_polygons would
+    //           read them from a file write produced at full precision,
+    //           without the text round trip. Adds one loop per vertex to
+    //           loopCounter, as read_polygons does.
+    void toPolygons(List<List<Vertex>> &polygons, int &loopCounter) const;
+};
+
+#endif /* map_generator_h */
@@ -0,0 +1,163 @@
+//
+//  perf_counters.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cstring>
+#include <cerrno>
+#include "perf_counters.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+using namespace std;
+
+#ifdef __linux__
+// perf_event_open config of each PerfEvent (all of type PERF_TYPE_HARDWARE)
+static const unsigned long long PERF_CONFIGS[NUM_PERF_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+// Layout of a read with PERF_FORMAT_TOTAL_TIME_ENABLED and
+// PERF_FORMAT_TOTAL_TIME_RUNNING
+struct PerfRead {
+    unsigned long long value;
+    unsigned long long timeEnabled;
+    unsigned long long timeRunning;
+};
+#endif
+
+// EFFECTS : Constructs the counters, all closed (see open)
+PerfCounters::PerfCounters()
+: openError(0) {
+    for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+        fds[i] = -1;
+        startEnabled[i] = startRunning[i] = 0;
+    }
+}
+
+// MODIFIES: this
+// EFFECTS : Closes any open counters
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+        if (fds[i] >= 0) {
+            close(fds[i]);
+        }
+    }
+#endif
+}
+
+// MODIFIES: this
+// EFFECTS : Opens every counter the system allows for the calling thread
+//           (stopped) and returns how many opened. Only that thread's
+//           work is counted afterwards.
+int PerfCounters::open() {
+    int opened = 0;
+#ifdef __linux__
+    for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+        if (fds[i] >= 0) {
+            ++opened;
+            continue;
+        }
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_CONFIGS[i];
+        attr.disabled = 1;
+        // User space only, which also works under perf_event_paranoid 2
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // pid 0, cpu -1: the calling thread, on whichever CPU it runs
+        fds[i] = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fds[i] >= 0) {
+            ++opened;
+        } else if (!openError) {
+            openError = errno;
+        }
+    }
+#else
+    openError = ENOSYS;
+#endif
+    return opened;
+}
+
+// EFFECTS : Returns a description of why the first counter that failed
+//           to open failed (empty if none did)
+string PerfCounters::unavailableReason() const {
+    return openError ? strerror(openError) : "";
+}
+
+// MODIFIES: this
+// EFFECTS : Zeroes the open counters, records their enabled and running
+//           times, and starts them
+void PerfCounters::start() {
+#ifdef __linux__
+    for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+        if (fds[i] >= 0) {
+            ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+            PerfRead result;
+            if (read(fds[i], &result, sizeof(result)) == sizeof(result)) {
+                startEnabled[i] = result.timeEnabled;
+                startRunning[i] = result.timeRunning;
+            }
+            ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+// MODIFIES: this
+// EFFECTS : Stops the open counters and returns their counts since start
+//           (scaled up if the kernel had to share the hardware between
+//           counters since start)
+PerfSample PerfCounters::stop() {
+    PerfSample sample;
+    for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+        sample.counts[i] = -1;
+    }
+#ifdef __linux__
+    // Stop them all before reading any, so reading is not counted
+    for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+        if (fds[i] >= 0) {
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+        PerfRead result;
+        if (fds[i] < 0 ||
+            read(fds[i], &result, sizeof(result)) != sizeof(result)) {
+            continue;
+        }
+        // Only the times since start matter; both keep growing from open
+        unsigned long long enabled = result.timeEnabled - startEnabled[i];
+        unsigned long long running = result.timeRunning - startRunning[i];
+        if (running == 0) {
+            // Never got a hardware counter, so nothing was measured
+            continue;
+        }
+        if (running < enabled) {
+            result.value = (unsigned long long)
+                ((double) result.value * enabled / running);
+        }
+        sample.counts[i] = (long long) result.value;
+    }
+#endif
+    return sample;
+}
+
+// MODIFIES: os
+// EFFECTS : Writes the counts of sample, in PerfEvent order and separated by
+//           spaces
+void printPerfSample(std::ostream &os, const PerfSample &sample) {
+    for (int i = 0; i < NUM_PERF_EVENTS; ++i) {
+        os << (i ? " " : "") << sample.counts[i];
+    }
+}
@@ -0,0 +1,83 @@
+//
+//  perf_counters.h
+//  Visibility Graph Path Planning
+//
+//  Optional hardware performance counters (Linux perf_event_open) around a
+//  phase of a run: CPU cycles, instructions, last-level cache misses and
+//  branch misses, counted in user space on the calling thread. Loop counters
+//  say how much work a phase did; these say whether it ran at full speed or
+//  waited on memory (instructions per cycle, cache misses per loop). Each
+//  counter is opened on its own, so a machine that offers only some of them
+//  still reports those, and on other systems, in containers without access,
+//  or under a restrictive perf_event_paranoid setting every count is
+//  reported as -1 instead of stopping the run.
+//
+
+#ifndef perf_counters_h
+#define perf_counters_h
+
+#include <iostream>
+#include <string>
+
+// The events counted, in the order they are printed
+enum PerfEvent {PERF_CYCLES, PERF_INSTRUCTIONS, PERF_CACHE_MISSES,
+                PERF_BRANCH_MISSES, NUM_PERF_EVENTS};
+
+// Counts of one phase, indexed by PerfEvent (-1 if the counter is not
+// available)
+struct PerfSample {
+    long long counts[NUM_PERF_EVENTS];
+};
+
+class PerfCounters {
+private:
+    // File descriptor of each counter (-1 if not open)
+    int fds[NUM_PERF_EVENTS];
+    // errno of the first counter that failed to open (0 if none did)
+    int openError;
+    // Time each counter had been enabled and running at the last start.
+    // Resetting a counter only zeroes its count, so stop scales by the
+    // times since then.
+    unsigned long long startEnabled[NUM_PERF_EVENTS];
+    unsigned long long startRunning[NUM_PERF_EVENTS];
+
+public:
+    // EFFECTS : Constructs the counters, all closed (see open)
+    PerfCounters();
+
+    // MODIFIES: this
+    // EFFECTS : Closes any open counters
+    ~PerfCounters();
+
+    // Each counter has one owner
+    PerfCounters(const PerfCounters &other) = delete;
+    PerfCounters & operator=(const PerfCounters &rhs) = delete;
+
+    // MODIFIES: this
+    // EFFECTS : Opens every counter the system allows for the calling thread
+    //           (stopped) and returns how many opened. Only that thread's
+    //           work is counted afterwards.
+    int open();
+
+    // EFFECTS : Returns a description of why the first counter that failed
+    //           to open failed (empty if none did)
+    std::string unavailableReason() const;
+
+    // MODIFIES: this
+    // EFFECTS : Zeroes the open counters, records their enabled and running
+    //           times, and starts them
+    void start();
+
+    // MODIFIES: this
+    // EFFECTS : Stops the open counters and returns their counts since start
+    //           (scaled up if the kernel had to share the hardware between
+    //           counters since start)
+    PerfSample stop();
+};
+
+// MODIFIES: os
+// EFFECTS : Writes the counts of sample, in PerfEvent order and separated by
+//           spaces
+void printPerfSample(std::ostream &os, const PerfSample &sample);
+
+#endif /* perf_counters_h */
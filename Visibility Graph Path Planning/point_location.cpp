@@ -0,0 +1,257 @@
+//
+//  point_location.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include "point_location.h"
+
+using namespace std;
+
+// Most cells along one axis, so the cell lists stay small on huge maps
+static const int MAX_CELLS_PER_SIDE = 1024;
+
+// REQUIRES: index was built
+// EFFECTS : Returns the cell along axis i that value falls in, clamped to
+//           the grid
+static int cellOf(const PointLocationIndex &index, double value, int i) {
+    double cell = floor((value - index.low[i]) / index.cellSize[i]);
+    if (cell < 0) {
+        return 0;
+    }
+    if (cell >= index.cellsPerSide) {
+        return index.cellsPerSide - 1;
+    }
+    return (int) cell;
+}
+
+// REQUIRES: polygons contains valid convex polygons and outlives index,
+//           index is empty
+// MODIFIES: index, loopCounter
+// EFFECTS : Builds a grid of about one cell per polygon over polygons and
+//           lists in each cell the polygons whose bounding boxes overlap it.
+//           Adds the number of (polygon, cell) entries to loopCounter.
+void buildPointLocationIndex(List<List<Vertex>> const &polygons,
+                             PointLocationIndex &index, int &loopCounter) {
+    // The grid covers the plane
+    static_assert(DIMENSIONS == 2, "the grid covers the plane");
+    assert(index.corners.empty());
+
+    // Flatten the polygons and their bounding boxes
+    List<List<Vertex>>::Iterator endP = polygons.end();
+    for (List<List<Vertex>>::Iterator pgon = polygons.begin(); pgon != endP;
+         ++pgon) {
+        if ((*pgon)->empty()) {
+            continue;
+        }
+        index.polygonStart.push_back((int) index.corners.size());
+        double box[2 * DIMENSIONS];
+        const Vertex *first = *(*pgon)->begin();
+        for (int i = 0; i < DIMENSIONS; ++i) {
+            box[i] = box[DIMENSIONS + i] = first->coord[i];
+        }
+        List<Vertex>::Iterator endV = (*pgon)->end();
+        for (List<Vertex>::Iterator v = (*pgon)->begin(); v != endV; ++v) {
+            index.corners.push_back(*v);
+            for (int i = 0; i < DIMENSIONS; ++i) {
+                box[i] = min(box[i], (*v)->coord[i]);
+                box[DIMENSIONS + i] = max(box[DIMENSIONS + i],
+                                          (*v)->coord[i]);
+            }
+        }
+        index.polygonBoxes.insert(index.polygonBoxes.end(), box,
+                                  box + 2 * DIMENSIONS);
+    }
+    const int numPolygons = (int) index.polygonStart.size();
+    index.polygonStart.push_back((int) index.corners.size());
+
+    // About one cell per polygon over the bounding box of all of them
+    double high[DIMENSIONS];
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        index.low[i] = numeric_limits<double>::infinity();
+        high[i] = -numeric_limits<double>::infinity();
+        for (int p = 0; p < numPolygons; ++p) {
+            const double *box = &index.polygonBoxes[2 * DIMENSIONS * p];
+            index.low[i] = min(index.low[i], box[i]);
+            high[i] = max(high[i], box[DIMENSIONS + i]);
+        }
+    }
+    index.cellsPerSide = max(1, min(MAX_CELLS_PER_SIDE,
+                                    (int) ceil(sqrt((double) numPolygons))));
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        double extent = numPolygons > 0 ? high[i] - index.low[i] : 0;
+        index.cellSize[i] = extent > 0 ? extent / index.cellsPerSide : 1;
+        if (numPolygons == 0) {
+            index.low[i] = 0;
+        }
+    }
+
+    // Count the polygons in each cell, then fill the lists (counting sort)
+    const int numCells = index.cellsPerSide * index.cellsPerSide;
+    index.cellStart.assign(numCells + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+        vector<int> next;
+        if (pass == 1) {
+            for (int c = 0; c < numCells; ++c) {
+                index.cellStart[c + 1] += index.cellStart[c];
+            }
+            index.cellPolygons.resize(index.cellStart[numCells]);
+            next.assign(index.cellStart.begin(), index.cellStart.end() - 1);
+        }
+        for (int p = 0; p < numPolygons; ++p) {
+            const double *box = &index.polygonBoxes[2 * DIMENSIONS * p];
+            int lowX = cellOf(index, box[0], 0);
+            int lowY = cellOf(index, box[1], 1);
+            int highX = cellOf(index, box[2], 0);
+            int highY = cellOf(index, box[3], 1);
+            for (int y = lowY; y <= highY; ++y) {
+                for (int x = lowX; x <= highX; ++x) {
+                    int cell = y * index.cellsPerSide + x;
+                    if (pass == 0) {
+                        ++index.cellStart[cell + 1];
+                    } else {
+                        index.cellPolygons[next[cell]++] = p;
+                        ++loopCounter;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// EFFECTS : Returns the number of bytes used by index
+size_t pointLocationMemory(const PointLocationIndex &index) {
+    return index.corners.capacity() * sizeof(const Vertex*) +
+           index.polygonStart.capacity() * sizeof(int) +
+           index.polygonBoxes.capacity() * sizeof(double) +
+           index.cellStart.capacity() * sizeof(int) +
+           index.cellPolygons.capacity() * sizeof(int);
+}
+
+// REQUIRES: index was built, 0 <= p < number of polygons in index
+// EFFECTS : Returns true if point is in the interior of polygon p: it is
+//           strictly on the inner side of every edge
+static bool insidePolygon(const PointLocationIndex &index, int p,
+                          const Vertex &point) {
+    const double *box = &index.polygonBoxes[2 * DIMENSIONS * p];
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        if (point.coord[i] <= box[i] ||
+            point.coord[i] >= box[DIMENSIONS + i]) {
+            return false;
+        }
+    }
+
+    const int first = index.polygonStart[p];
+    const int last = index.polygonStart[p + 1] - 1;
+    // All edges must turn the same way toward point (either way, so both
+    // orientations work)
+    int side = 0;
+    for (int i = first; i <= last; ++i) {
+        const Vertex &a = *index.corners[i];
+        const Vertex &b = *index.corners[i == last ? first : i + 1];
+        int turn = orientationSign(a, b, point);
+        if (turn == 0 || (side != 0 && turn != side)) {
+            return false;
+        }
+        side = turn;
+    }
+    return side != 0;
+}
+
+// REQUIRES: index was built
+// EFFECTS : Returns the position in index of the polygon whose interior
+//           contains point, or -1 if there is none
+static int containingEntry(const PointLocationIndex &index,
+                           const Vertex &point) {
+    // Points outside the grid fall in a border cell, and the bounding boxes
+    // there reject them
+    int cell = cellOf(index, point.coord[1], 1) * index.cellsPerSide +
+               cellOf(index, point.coord[0], 0);
+    for (int c = index.cellStart[cell]; c < index.cellStart[cell + 1]; ++c) {
+        int p = index.cellPolygons[c];
+        if (insidePolygon(index, p, point)) {
+            return p;
+        }
+    }
+    return -1;
+}
+
+// REQUIRES: index was built, point has been snapped (see snapToGrid)
+// EFFECTS : Returns the polygon index (see Vertex) of the polygon whose
+//           interior contains point, or -1 if point is not inside any
+//           polygon. Points on a polygon's boundary are not inside it.
+int containingPolygon(const PointLocationIndex &index, const Vertex &point) {
+    int p = containingEntry(index, point);
+    return p == -1 ? -1 : index.corners[index.polygonStart[p]]->polygon;
+}
+
+// REQUIRES: index was built, margin > 0 (and larger than the fixed-point
+//           resolution in fixed-point mode)
+// MODIFIES: point
+// EFFECTS : If point is inside a polygon, moves it to the nearest point of
+//           that polygon's boundary and then margin further out, and snaps
+//           it (see snapToGrid). Returns true if point ends up outside every
+//           polygon (always if it started outside), false if the moved point
+//           landed inside another polygon.
+bool snapOutOfObstacle(const PointLocationIndex &index, Vertex &point,
+                       double margin) {
+    assert(margin > 0);
+    int p = containingEntry(index, point);
+    if (p == -1) {
+        return true;
+    }
+
+    // The polygon is the intersection of its edges' half-planes, so the
+    // nearest boundary point is the projection onto the nearest edge line
+    const int first = index.polygonStart[p];
+    const int last = index.polygonStart[p + 1] - 1;
+    double bestDistance = numeric_limits<double>::infinity();
+    double outward[DIMENSIONS] = {0, 0};
+    for (int i = first; i <= last; ++i) {
+        const Vertex &a = *index.corners[i];
+        const Vertex &b = *index.corners[i == last ? first : i + 1];
+        double normal[DIMENSIONS] = {b.coord[1] - a.coord[1],
+                                     a.coord[0] - b.coord[0]};
+        double length = hypot(normal[0], normal[1]);
+        if (length == 0) {
+            continue;
+        }
+        // Signed distance of point along the normal; point is inside, so the
+        // normal points outward where this is negative
+        double distance = ((point.coord[0] - a.coord[0]) * normal[0] +
+                           (point.coord[1] - a.coord[1]) * normal[1]) / length;
+        double sign = distance > 0 ? -1 : 1;
+        if (fabs(distance) < bestDistance) {
+            bestDistance = fabs(distance);
+            outward[0] = sign * normal[0] / length;
+            outward[1] = sign * normal[1] / length;
+        }
+    }
+
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        point.coord[i] += (bestDistance + margin) * outward[i];
+    }
+    snapToGrid(point);
+    return containingEntry(index, point) == -1;
+}
+
+// REQUIRES: index was built, every point has been snapped
+// MODIFIES: containing
+// EFFECTS : Sets containing[i] to containingPolygon(index, points[i]) for
+//           every point. Returns the number of points inside a polygon.
+int locatePoints(const PointLocationIndex &index,
+                 const std::vector<Vertex> &points,
+                 std::vector<int> &containing) {
+    containing.resize(points.size());
+    int blocked = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        containing[i] = containingPolygon(index, points[i]);
+        if (containing[i] != -1) {
+            ++blocked;
+        }
+    }
+    return blocked;
+}
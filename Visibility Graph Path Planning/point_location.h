@@ -0,0 +1,76 @@
+//
+//  point_location.h
+//  Visibility Graph Path Planning
+//
+//  Point-in-obstacle queries for start and goal points. visibleVertices
+//  requires that its vertex is not inside a polygon, but nothing checks a
+//  user's points, and testing mode only avoids obstacles through the circles
+//  it generates polygons in. A uniform grid is laid over the polygons and
+//  each cell lists the polygons whose bounding boxes overlap it, so a query
+//  only tests the few convex polygons in its cell, each with one orientation
+//  test per edge.
+//
+
+#ifndef point_location_h
+#define point_location_h
+
+#include <vector>
+#include "preprocessing.h"
+
+struct PointLocationIndex {
+    // Corners of every polygon, back to back; polygon p runs from
+    // corners[polygonStart[p]] to corners[polygonStart[p + 1] - 1]. They
+    // point into the polygons list the index was built from.
+    std::vector<const Vertex*> corners;
+    std::vector<int> polygonStart;
+    // Bounding box of each polygon (low x, low y, high x, high y)
+    std::vector<double> polygonBoxes;
+    // Grid over the bounding box of all polygons, cellsPerSide cells along
+    // each axis
+    double low[DIMENSIONS];
+    double cellSize[DIMENSIONS];
+    int cellsPerSide;
+    // The polygons overlapping cell c are
+    // cellPolygons[cellStart[c]] to cellPolygons[cellStart[c + 1] - 1]
+    std::vector<int> cellStart;
+    std::vector<int> cellPolygons;
+};
+
+// REQUIRES: polygons contains valid convex polygons and outlives index,
+//           index is empty
+// MODIFIES: index, loopCounter
+// EFFECTS : Builds a grid of about one cell per polygon over polygons and
+//           lists in each cell the polygons whose bounding boxes overlap it.
+//           Adds the number of (polygon, cell) entries to loopCounter.
+void buildPointLocationIndex(List<List<Vertex>> const &polygons,
+                             PointLocationIndex &index, int &loopCounter);
+
+// EFFECTS : Returns the number of bytes used by index
+size_t pointLocationMemory(const PointLocationIndex &index);
+
+// REQUIRES: index was built, point has been snapped (see snapToGrid)
+// EFFECTS : Returns the polygon index (see Vertex) of the polygon whose
+//           interior contains point, or -1 if point is not inside any
+//           polygon. Points on a polygon's boundary are not inside it.
+int containingPolygon(const PointLocationIndex &index, const Vertex &point);
+
+// REQUIRES: index was built, margin > 0 (and larger than the fixed-point
+//           resolution in fixed-point mode)
+// MODIFIES: point
+// EFFECTS : If point is inside a polygon, moves it to the nearest point of
+//           that polygon's boundary and then margin further out, and snaps
+//           it (see snapToGrid). Returns true if point ends up outside every
+//           polygon (always if it started outside), false if the moved point
+//           landed inside another polygon.
+bool snapOutOfObstacle(const PointLocationIndex &index, Vertex &point,
+                       double margin);
+
+// REQUIRES: index was built, every point has been snapped
+// MODIFIES: containing
+// EFFECTS : Sets containing[i] to containingPolygon(index, points[i]) for
+//           every point. Returns the number of points inside a polygon.
+int locatePoints(const PointLocationIndex &index,
+                 const std::vector<Vertex> &points,
+                 std::vector<int> &containing);
+
+#endif /* point_location_h */
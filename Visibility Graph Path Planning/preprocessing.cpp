@@ -8,60 +8,279 @@
 
 #include <stdio.h>
 #include <cmath>
+#include <type_traits>
 #include "preprocessing.h"
+#include "trace.h"
 
 using namespace std;
 
+// Copying a Vertex should be a plain block copy, and the orientation kernels
+// are only defined in the plane
+static_assert(is_trivially_copyable<Vertex>::value,
+              "Vertex must be trivially copyable");
+static_assert(DIMENSIONS == 2, "orientation requires two dimensions");
+
 // Constructs an empty graph that owns its vertices and edges
 Graph::Graph() :
 vertices(true), connections(true) {}
 
-// REQUIRES: a and b do not have extremely large absolute values
-// EFFECTS: returns true if a and b are within EPSILON of one another,
-//         false otherwise
-static bool compareDoubles(double a, double b) {
-    return fabs(a - b) < __DBL_EPSILON__;
+// Orientation tests run by this thread (see predicateCounters)
+static thread_local PredicateCounters threadPredicateCounters = {0, 0, 0};
+
+// Fixed-point resolution (0 in floating-point mode) and its reciprocal
+static double fixedResolution = 0;
+static double fixedScale = 0;
+
+// Integer type wide enough for the exact fixed-point cross product
+__extension__ typedef __int128 WideInt;
+
+// Fixed-point coordinates must stay below this in magnitude, so that a
+// snapped coordinate times fixedScale rounds back to its exact multiple (the
+// two roundings are off by less than a quarter there), and the cross product
+// of their differences easily fits in WideInt
+static const double FIXED_LIMIT = 1125899906842624.0; // 2^50
+
+// Adding and then subtracting 1.5 * 2^52 rounds a double below 2^51 in
+// magnitude to the nearest integer without a library call
+static const double ROUND_MAGIC = 6755399441055744.0;
+
+// Unit roundoff of a double (2^-53)
+static const double ROUNDOFF = __DBL_EPSILON__ / 2;
+
+// A point is only inside a cone if its cross products with the cone's edges
+// are larger than this times the product of the vectors' sizes, which is far
+// above their rounding error (borderline points go on to the edge tests)
+static const double CONE_MARGIN = 1e-12;
+
+// Vertices connected per traced chunk of makeConnections (see trace.h)
+static const int TRACE_CHUNK = 64;
+
+// If the rounded cross product in orientation is larger in magnitude than
+// this times the sum of the magnitudes of its two products, its sign is
+// certain (Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast
+// Robust Geometric Predicates", 1997)
+static const double ORIENTATION_ERROR_BOUND = (3.0 + 16.0 * ROUNDOFF) *
+                                              ROUNDOFF;
+
+// MODIFIES: sum, error
+// EFFECTS : Sets sum to the rounded a + b and error to its roundoff, so that
+//           sum + error == a + b exactly
+static void twoSum(double a, double b, double &sum, double &error) {
+    sum = a + b;
+    double bVirtual = sum - a;
+    double aVirtual = sum - bVirtual;
+    error = (a - aVirtual) + (b - bVirtual);
 }
 
-// REQUIRES: dimensions > 0, v1.coord[] and v2.coord[] are of size dimensions
-// EFFECTS : returns the distance between v1 and v2
-double distanceFormula(const Vertex& v1, const Vertex& v2,
-                              const int dimensions) {
-    double sumOfSquares = 0;
-    for (int i = 0; i < dimensions; ++i) {
-        sumOfSquares += pow(v1.coord[i] - v2.coord[i], 2);
+// MODIFIES: product, error
+// EFFECTS : Sets product to the rounded a * b and error to its roundoff, so
+//           that product + error == a * b exactly
+static void twoProduct(double a, double b, double &product, double &error) {
+    product = a * b;
+    error = fma(a, b, -product);
+}
+
+// REQUIRES: expansion[0, length) is a nonoverlapping expansion ordered by
+//           increasing magnitude with no zero components, and has room for
+//           one more component
+// MODIFIES: expansion, length
+// EFFECTS : Adds b to the expansion exactly, keeping it in that form
+static void growExpansion(double *expansion, int &length, double b) {
+    double carry = b;
+    int newLength = 0;
+    for (int i = 0; i < length; ++i) {
+        double component;
+        twoSum(carry, expansion[i], carry, component);
+        if (component != 0) {
+            expansion[newLength++] = component;
+        }
+    }
+    if (carry != 0) {
+        expansion[newLength++] = carry;
+    }
+    length = newLength;
+}
+
+// REQUIRES: all parameters are valid vertices
+// EFFECTS : Same as orientation, computed with exact arithmetic
+static int exactOrientation(Vertex const &p1, Vertex const &p2,
+                            Vertex const &p3) {
+    // The formula is a * b - c * d. Each difference is exactly the sum of
+    // two doubles, and each product of those exactly the sum of two more.
+    double a[2], b[2], c[2], d[2];
+    twoSum(p2.coord[1], -p1.coord[1], a[0], a[1]);
+    twoSum(p3.coord[0], -p2.coord[0], b[0], b[1]);
+    twoSum(p3.coord[1], -p2.coord[1], c[0], c[1]);
+    twoSum(p2.coord[0], -p1.coord[0], d[0], d[1]);
+    
+    double expansion[17];
+    int length = 0;
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            double product, error;
+            twoProduct(a[i], b[j], product, error);
+            growExpansion(expansion, length, product);
+            growExpansion(expansion, length, error);
+            twoProduct(-c[i], d[j], product, error);
+            growExpansion(expansion, length, product);
+            growExpansion(expansion, length, error);
+        }
     }
     
-    return sqrt(sumOfSquares);
+    // The largest component decides the sign
+    if (length == 0) {
+        return 0;
+    }
+    return expansion[length - 1] > 0 ? 1 : -1;
 }
 
+// A snapped vertex as multiples of the resolution
+struct FixedPoint {
+    long long x;
+    long long y;
+};
+
+// REQUIRES: v has been snapped (see snapToGrid)
+// EFFECTS : Returns v's coordinates as multiples of the resolution
+static inline FixedPoint toFixed(Vertex const &v) {
+    FixedPoint p;
+    p.x = (long long) ((v.coord[0] * fixedScale + ROUND_MAGIC) - ROUND_MAGIC);
+    p.y = (long long) ((v.coord[1] * fixedScale + ROUND_MAGIC) - ROUND_MAGIC);
+    return p;
+}
+
+// EFFECTS : Same as orientation, computed exactly on fixed-point coordinates
+static inline int fixedOrientation(FixedPoint const &p1, FixedPoint const &p2,
+                                   FixedPoint const &p3) {
+    WideInt left = (WideInt) (p2.y - p1.y) * (p3.x - p2.x);
+    WideInt right = (WideInt) (p3.y - p2.y) * (p2.x - p1.x);
+    return (left > right) - (left < right);
+}
 
 // REQUIRES: all parameters are valid vertices
 // EFFECTS : returns 1 if orientation of (p1, p2, p3) is clockwise
 //           returns -1 if orientation of (p1, p2, p3) is counterclockwise
 //           returns 0 if (p1, p2, p3) are colinear
+//           The answer is exact: the floating-point result is used when the
+//           error bound shows its sign is right, exactOrientation otherwise.
 // NOTE    : Helper function for intersect
 //           Credit: http://www.geeksforgeeks.org/orientation-3-ordered-points/
-static int orientation (Vertex const p1, Vertex const p2, Vertex const p3) {
-    // Orientation formula: (y2 - y1)*(x3 - x2) - (y3 - y2)*(x2 - x1)
-    double result = (p2.coord[1] - p1.coord[1]) * (p3.coord[0] - p2.coord[0])
-                 - (p3.coord[1] - p2.coord[1]) * (p2.coord[0] - p1.coord[0]);
-    if (compareDoubles(result, 0.0)) {
-        return 0;
+static inline int orientation (Vertex const &p1, Vertex const &p2, Vertex const &p3) {
+    // Integer coordinates are always exact
+    if (fixedResolution > 0) {
+        ++threadPredicateCounters.fast;
+        return fixedOrientation(toFixed(p1), toFixed(p2), toFixed(p3));
     }
-    if (result > 0) {
+    
+    // Orientation formula: (y2 - y1)*(x3 - x2) - (y3 - y2)*(x2 - x1)
+    double left, right;
+    orientationProducts(p1, p2, p3, left, right);
+    double result = left - right;
+    double bound = ORIENTATION_ERROR_BOUND * (fabs(left) + fabs(right));
+    
+    if (result > bound) {
+        ++threadPredicateCounters.fast;
         return 1;
     }
-    return -1;
+    if (result < -bound) {
+        ++threadPredicateCounters.fast;
+        return -1;
+    }
+    ++threadPredicateCounters.exact;
+    return exactOrientation(p1, p2, p3);
+}
+
+// REQUIRES: all parameters are valid vertices (snapped in fixed-point mode)
+// EFFECTS : Exact orientation test, the same one intersect uses. Returns 1 if
+//           (p1, p2, p3) turn clockwise, -1 if counterclockwise, 0 if they
+//           are collinear.
+int orientationSign(Vertex const &p1, Vertex const &p2, Vertex const &p3) {
+    return orientation(p1, p2, p3);
+}
+
+// REQUIRES: cone is the interior cone of corner (see findPolygonCones)
+// EFFECTS : Returns true if point is certainly strictly inside cone. Returns
+//           false if it is outside, on the boundary, too close to the
+//           boundary to tell, or corner has no cone.
+static inline bool insideCone(const CornerCone &cone, const Vertex &corner,
+                              const Vertex &point) {
+    double dx = point.coord[0] - corner.coord[0];
+    double dy = point.coord[1] - corner.coord[1];
+    double pointSize = fabs(dx) + fabs(dy);
+    
+    const double *start = cone.start;
+    double startCross = start[0] * dy - start[1] * dx;
+    if (startCross <= CONE_MARGIN * (fabs(start[0]) + fabs(start[1])) *
+                      pointSize) {
+        return false;
+    }
+    const double *end = cone.end;
+    double endCross = dx * end[1] - dy * end[0];
+    return endCross > CONE_MARGIN * (fabs(end[0]) + fabs(end[1])) * pointSize;
+}
+
+// REQUIRES: v is a polygon vertex, cones was filled by findPolygonCones from
+//           the polygons v belongs to
+// EFFECTS : Returns the interior cone of v
+static inline const CornerCone & coneOf(const PolygonCones &cones,
+                                        const Vertex &v) {
+    assert(v.polygon < (int) cones.size() &&
+           v.location < (int) cones[v.polygon].size());
+    return cones[v.polygon][v.location];
+}
+
+// EFFECTS : Returns the orientation test counts of the calling thread. They
+//           can be reset by assigning to the result.
+PredicateCounters & predicateCounters() {
+    return threadPredicateCounters;
+}
+
+// REQUIRES: resolution >= 0, no vertices have been read or snapped yet (or
+//           they were read with the same resolution)
+// MODIFIES: the coordinate mode of the program
+// EFFECTS : resolution > 0 turns on fixed-point mode: coordinates are rounded
+//           to multiples of resolution as they are read (see snapToGrid), and
+//           orientation tests use exact integer arithmetic on the multiples.
+//           Coordinates and distances stay in the original units. 0 turns it
+//           off (the default).
+void setFixedPointResolution(double resolution) {
+    assert(resolution >= 0);
+    fixedResolution = resolution;
+    fixedScale = resolution > 0 ? 1 / resolution : 0;
+}
+
+// EFFECTS : Returns the fixed-point resolution (0 if fixed-point mode is off)
+double fixedPointResolution() {
+    return fixedResolution;
+}
+
+// REQUIRES: v's coordinates are less than 2^50 times the resolution in
+//           magnitude
+// MODIFIES: v
+// EFFECTS : In fixed-point mode, rounds v's coordinates to the nearest
+//           multiple of the resolution (orientation recovers the multiples
+//           from them). Does nothing otherwise. Every vertex not read by
+//           preProcess (start, goal, generated points) must be snapped
+//           before it is used.
+void snapToGrid(Vertex &v) {
+    if (fixedResolution == 0) {
+        return;
+    }
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        double multiple = round(v.coord[i] / fixedResolution);
+        assert(fabs(multiple) < FIXED_LIMIT);
+        v.coord[i] = multiple * fixedResolution;
+    }
 }
 
 // REQUIRES: polygons is an empty List of polygons, 'is' is a valid
 //           input stream that has been opened and is in the correct format
-// MODIFIES: polygons
+// MODIFIES: polygons, is
 // EFFECTS : reads vertices from is and places them into polygons. Adds the
 //           number of loops run to loop counter
-static void read_polygons(List<List<Vertex>>& polygons, istream& is,
-                          int &loopCounter) {
+void read_polygons(List<List<Vertex>>& polygons, std::istream& is,
+                   int &loopCounter) {
+    TraceScope trace("read_polygons");
     assert(polygons.empty());
     
     int polygon_index = 0;
@@ -74,10 +293,11 @@ static void read_polygons(List<List<Vertex>>& polygons, istream& is,
         List<Vertex> *polygon = new List<Vertex>(true);
         for (int i = 0; i < DIMENSIONS * num_vertices; i += DIMENSIONS) {
             // DIMENSIONS = num of coord per vertex
-            Vertex *v = new Vertex;
+            Vertex *v = new Vertex();
             for (int j = 0; j < DIMENSIONS; ++j) {
                 is >> v->coord[j];
             }
+            snapToGrid(*v);
             v->polygon = polygon_index;
             v->location = i / DIMENSIONS;
             v->poly_size = num_vertices;
@@ -92,16 +312,83 @@ static void read_polygons(List<List<Vertex>>& polygons, istream& is,
     }
 }
 
-// Vertex assignment operator
-Vertex& Vertex::operator=(const Vertex& rhs) {
-    for (int i = 0; i < DIMENSIONS; ++i) {
-        coord[i] = rhs.coord[i];
+// REQUIRES: polygon contains a valid polygon whose vertices are numbered
+//           (location) in order
+// MODIFIES: cones
+// EFFECTS : Sets cones to the interior cone of every vertex of polygon, by
+//           location
+static void findCones(const List<Vertex> &polygon,
+                      std::vector<CornerCone> &cones) {
+    cones.assign(polygon.size(), CornerCone());
+    
+    // Twice the signed area: positive if polygon runs counterclockwise
+    double area = 0;
+    List<Vertex>::Iterator v = polygon.begin();
+    for (int i = 0; i < polygon.size(); ++i) {
+        List<Vertex>::Iterator next = v;
+        next.circularIncrement(polygon.begin());
+        area += (*v)->coord[0] * (*next)->coord[1] -
+                (*next)->coord[0] * (*v)->coord[1];
+        v = next;
     }
-    polygon = rhs.polygon;
-    location = rhs.location;
-    poly_size = rhs.poly_size;
     
-    return *this;
+    // Walk (previous, current, next) around the polygon
+    List<Vertex>::Iterator previous = polygon.begin();
+    for (int i = 0; i < polygon.size() - 1; ++i) {
+        ++previous;
+    }
+    List<Vertex>::Iterator current = polygon.begin();
+    for (int i = 0; i < polygon.size(); ++i) {
+        List<Vertex>::Iterator next = current;
+        next.circularIncrement(polygon.begin());
+        
+        double toPrevious[DIMENSIONS];
+        double toNext[DIMENSIONS];
+        for (int j = 0; j < DIMENSIONS; ++j) {
+            toPrevious[j] = (*previous)->coord[j] - (*current)->coord[j];
+            toNext[j] = (*next)->coord[j] - (*current)->coord[j];
+        }
+        // The polygon turns toward its interior at a convex corner, so the
+        // interior runs counterclockwise from the next edge to the previous
+        // one in a counterclockwise polygon (and the other way around in a
+        // clockwise one). Reflex and flat corners keep a zero cone.
+        double turn = toNext[0] * toPrevious[1] - toNext[1] * toPrevious[0];
+        assert((*current)->location >= 0 &&
+               (*current)->location < polygon.size());
+        CornerCone &cone = cones[(*current)->location];
+        if (turn * area > 0) {
+            for (int j = 0; j < DIMENSIONS; ++j) {
+                cone.start[j] = area > 0 ? toNext[j] : toPrevious[j];
+                cone.end[j] = area > 0 ? toPrevious[j] : toNext[j];
+            }
+        }
+        
+        previous = current;
+        current = next;
+    }
+}
+
+// REQUIRES: polygons contains valid polygons, numbered as read_polygons
+//           numbers them (indices need not be contiguous)
+// MODIFIES: cones
+// EFFECTS : Sets cones to the interior cone of every polygon vertex, indexed
+//           by polygon index and then location, for visible to reject
+//           segments that leave a corner into its own polygon. The table
+//           describes polygons as they are now; build it again after
+//           changing them.
+void findPolygonCones(List<List<Vertex>> const &polygons,
+                      PolygonCones &cones) {
+    cones.clear();
+    List<List<Vertex>>::Iterator endP = polygons.end();
+    for (List<List<Vertex>>::Iterator pgon = polygons.begin(); pgon != endP;
+         ++pgon) {
+        const int index = (*(*pgon)->begin())->polygon;
+        assert(index >= 0);
+        if (index >= (int) cones.size()) {
+            cones.resize(index + 1);
+        }
+        findCones(**pgon, cones[index]);
+    }
 }
 
 // REQUIRES: graph is an empty graph, polygonFile has been opened properly and
@@ -118,6 +405,7 @@ void preProcess(Graph &graph, std::istream& polygonFile,
                 List<List<Vertex>> &polygons, int &readPolygonsCounter,
                 int &addVerticesCounter, int &makeConnectionsCounter,
                 int &visibleVerticesCounter, int &visibleCounter) {
+    TraceScope trace("preProcess");
     
     // polygons will own the dynamically allocated polygons
     read_polygons(polygons, polygonFile, readPolygonsCounter);
@@ -128,6 +416,26 @@ void preProcess(Graph &graph, std::istream& polygonFile,
                     visibleVerticesCounter, visibleCounter);
 }
 
+// REQUIRES: polygons contains valid polygon objects
+// MODIFIES: os
+// EFFECTS : Writes polygons to os in the polygon file format read by
+//           preProcess (the caller chooses the precision of os)
+void writePolygons(std::ostream &os, List<List<Vertex>> const &polygons) {
+    // Traversal by Iterator
+    List<List<Vertex>>::Iterator endP = polygons.end();
+    for (List<List<Vertex>>::Iterator pgon = polygons.begin(); pgon != endP;
+         ++pgon) {
+        os << (*pgon)->size() << endl;
+        List<Vertex>::Iterator endV = (*pgon)->end();
+        for (List<Vertex>::Iterator v = (*pgon)->begin(); v != endV; ++v) {
+            for (int i = 0; i < DIMENSIONS; ++i) {
+                os << (*v)->coord[i] << " ";
+            }
+        }
+        os << endl;
+    }
+}
+
 // REQUIRES: graph is an empty Graph, polygons contains polygon objects with
 //           coordinates in the correct format
 // MODIFIES: graph
@@ -135,6 +443,7 @@ void preProcess(Graph &graph, std::istream& polygonFile,
 //           of loops run to loopCounter
 void addVertices(Graph &graph, List<List<Vertex>> const &polygons,
                  int &loopCounter) {
+    TraceScope trace("addVertices");
     // Check graph is empty
     assert(graph.vertices.empty() && graph.connections.empty());
     
@@ -174,14 +483,21 @@ void makeConnections(Graph &graph, List<List<Vertex>> const &polygons,
     if (graph.vertices.empty()) {
         return;
     }
+    TraceScope trace("makeConnections");
+    PolygonCones cones;
+    findPolygonCones(polygons, cones);
     
-    // Traversal by Iterator
+    // Traversal by Iterator, traced in chunks of vertices
     List<Vertex>::Iterator end = graph.vertices.end();
-    for (List<Vertex>::Iterator v = graph.vertices.begin(); v != end; ++v) {
-        visibleVertices(v, graph, polygons, visibleVerticesCounter,
-                        visibleCounter);
-        
-        ++loopCounter;
+    List<Vertex>::Iterator v = graph.vertices.begin();
+    for (int chunk = 0; v != end; ++chunk) {
+        TraceScope chunkTrace("makeConnections chunk", chunk);
+        for (int i = 0; i < TRACE_CHUNK && v != end; ++i, ++v) {
+            visibleVertices(v, graph, polygons, visibleVerticesCounter,
+                            visibleCounter, &cones);
+            
+            ++loopCounter;
+        }
     }
 }
 
@@ -191,10 +507,10 @@ void makeConnections(Graph &graph, List<List<Vertex>> const &polygons,
 // MODIFIES: graph
 // EFFECTS : adds all possible paths from v that are indexed higher (listed
 //           later) in graph to graph as edges. Adds the number of loops run to
-//           loopCounter
+//           loopCounter. cones, if given, is passed on to visible.
 void visibleVertices(List<Vertex>::Iterator v, Graph &graph,
                      List<List<Vertex>> const &polygons, int &loopCounter,
-                     int &visibleCounter) {
+                     int &visibleCounter, const PolygonCones *cones) {
     
     // First vertex after v
     List<Vertex>::Iterator firstCheck = v;
@@ -206,10 +522,10 @@ void visibleVertices(List<Vertex>::Iterator v, Graph &graph,
     // Loop through higher-indexed vertices above v
     for (List<Vertex>::Iterator check = firstCheck; check != end; ++check) {
         
-        if (visible(**v, **check, polygons, visibleCounter)) {
+        if (visible(**v, **check, polygons, visibleCounter, cones)) {
             
             // check is visible from v and vice versa, build an edge
-            double distance = distanceFormula(**v, **check, DIMENSIONS);
+            double distance = distanceFormula(**v, **check);
             
             // Give each new edge pointers to vertices
             // NOTE: vertices in edge are owned by graph's vertices list
@@ -231,9 +547,11 @@ void visibleVertices(List<Vertex>::Iterator v, Graph &graph,
 // EFFECTS : adds all possible paths from v that are indexed higher (listed
 //           later) in graph to graph as edges. Also adds these edges to victims
 //           for later deletion. Adds the number of loops run to loopCounter.
+//           cones, if given, is passed on to visible.
 void visibleVertices(List<Vertex>::Iterator v, Graph &graph,
                      List<List<Vertex>> const &polygons, int &loopCounter,
-                     int &visibleCounter, List<Edge> &victims) {
+                     int &visibleCounter, List<Edge> &victims,
+                     const PolygonCones *cones) {
     
     // First vertex after v
     List<Vertex>::Iterator firstCheck = v;
@@ -245,10 +563,10 @@ void visibleVertices(List<Vertex>::Iterator v, Graph &graph,
     // Loop through higher-indexed vertices above v
     for (List<Vertex>::Iterator check = firstCheck; check != end; ++check) {
         
-        if (visible(**v, **check, polygons, visibleCounter)) {
+        if (visible(**v, **check, polygons, visibleCounter, cones)) {
             
             // check is visible from v and vice versa, build an edge
-            double distance = distanceFormula(**v, **check, DIMENSIONS);
+            double distance = distanceFormula(**v, **check);
             
             // Give each new edge pointers to vertices
             // NOTE: vertices in edge are owned by graph's vertices list
@@ -270,9 +588,12 @@ void visibleVertices(List<Vertex>::Iterator v, Graph &graph,
 // EFFECTS : returns true if check is visible from v (the line segment
 //           connecting check and v does intersect any polygon edges);
 //           returns false otherwise. Adds the number of loops run to
-//           loopCounter
+//           loopCounter. If cones (see findPolygonCones) is given, segments
+//           that leave an endpoint into its own polygon are rejected before
+//           any edge is tested.
 bool visible(const Vertex& v, const Vertex& check,
-             List<List<Vertex>> const &polygons, int &loopCounter) {
+             List<List<Vertex>> const &polygons, int &loopCounter,
+             const PolygonCones *cones) {
 
     // Bug Fix (Oct 29, 2017): Each vertex now carries a polygon index. If these
     // are equal, the vertices are part of the same polygon. Then, check if they
@@ -337,6 +658,16 @@ bool visible(const Vertex& v, const Vertex& check,
     }
     
     // End Bug Fix Oct 30, 2017
+    
+    // A segment that leaves either endpoint into the interior of its own
+    // convex corner passes through that polygon
+    if (cones != nullptr &&
+        ((v.polygon != -1 && insideCone(coneOf(*cones, v), v, check)) ||
+         (check.polygon != -1 && insideCone(coneOf(*cones, check), check,
+                                            v)))) {
+        ++threadPredicateCounters.coneRejections;
+        return false;
+    }
 
     // Traversal by Iterator
     List<List<Vertex>>::Iterator endP = polygons.end();
@@ -391,10 +722,22 @@ bool intersect(Vertex const& a1, Vertex const& a2,
     }
     
     // Get 4 orientations of interest
-    int o1 = orientation(a1, a2, b1);
-    int o2 = orientation(a1, a2, b2);
-    int o3 = orientation(b1, b2, a1);
-    int o4 = orientation(b1, b2, a2);
+    int o1, o2, o3, o4;
+    if (fixedResolution > 0) {
+        // Convert each endpoint once rather than once per orientation
+        FixedPoint fa1 = toFixed(a1), fa2 = toFixed(a2);
+        FixedPoint fb1 = toFixed(b1), fb2 = toFixed(b2);
+        threadPredicateCounters.fast += 4;
+        o1 = fixedOrientation(fa1, fa2, fb1);
+        o2 = fixedOrientation(fa1, fa2, fb2);
+        o3 = fixedOrientation(fb1, fb2, fa1);
+        o4 = fixedOrientation(fb1, fb2, fa2);
+    } else {
+        o1 = orientation(a1, a2, b1);
+        o2 = orientation(a1, a2, b2);
+        o3 = orientation(b1, b2, a1);
+        o4 = orientation(b1, b2, a2);
+    }
     
     // Examples 1 and 2 of general case
     if (o1 != o2 && o3 != o4) {
@@ -404,17 +747,6 @@ bool intersect(Vertex const& a1, Vertex const& a2,
     return false;
 }
 
-// EFFECTS : Returns true if lhs and rhs have the same coordinates.
-bool operator==(const Vertex &lhs, const Vertex &rhs) {
-    for (int i = 0; i < DIMENSIONS; ++i) {
-        if (!compareDoubles(lhs.coord[i], rhs.coord[i])) {
-            return false;
-        }
-    }
-    // All coordinates were equal
-    return true;
-}
-
 // REQUIRES: v is a valid Vertex
 // MODIFIES: os
 // EFFECTS : Prints the Vertex to os (coordinates only)
@@ -12,29 +12,31 @@
 #include <vector>
 #include <iostream>
 #include "List.h"
+#include "geometry.h"
 
 const int DIMENSIONS = 2;
 
-// Contains coordinates
-struct Vertex {
-    double coord[DIMENSIONS];
-    // Which polygon the Vertex is a member of (-1 if not part of a polygon)
-    int polygon;
-    // Which index within that polygon Vertex is (-1 if not part of a polygon)
-    int location;
-    // How many vertices the polygon that Vertex is part of contains (-1 if not
-    // part of a polygon)
-    int poly_size;
-    
-    // Vertex assignment operator
-    Vertex& operator=(const Vertex& rhs);
-};
+// Contains coordinates (see BasicVertex)
+typedef BasicVertex<DIMENSIONS> Vertex;
 
 // Contains a linked list of coordinates
 //struct Polygon {
 //    List<Vertex> polygonVertices;
 //};
 
+// Interior cone of a convex polygon corner: the directions from the vertex to
+// its two polygon neighbors, ordered so the cone turns counterclockwise from
+// start to end. Both are zero if the corner is not convex.
+struct CornerCone {
+    double start[DIMENSIONS];
+    double end[DIMENSIONS];
+};
+
+// Interior cones of polygon vertices, indexed by polygon index and then
+// location (see findPolygonCones). Kept beside the polygons rather than in
+// every Vertex.
+typedef std::vector<std::vector<CornerCone>> PolygonCones;
+
 // Contains two vertex endpoints and length of edge between them
 struct Edge {
     const Vertex* v1;
@@ -51,10 +53,28 @@ struct Graph {
     Graph();
 };
 
-// REQUIRES: dimensions > 0, v1.coord[] and v2.coord[] are of size dimensions
-// EFFECTS : returns the distance between v1 and v2
-double distanceFormula(const Vertex& v1, const Vertex& v2,
-                       const int dimensions);
+// REQUIRES: resolution >= 0, no vertices have been read or snapped yet (or
+//           they were read with the same resolution)
+// MODIFIES: the coordinate mode of the program
+// EFFECTS : resolution > 0 turns on fixed-point mode: coordinates are rounded
+//           to multiples of resolution as they are read (see snapToGrid), and
+//           orientation tests use exact integer arithmetic on the multiples.
+//           Coordinates and distances stay in the original units. 0 turns it
+//           off (the default).
+void setFixedPointResolution(double resolution);
+
+// EFFECTS : Returns the fixed-point resolution (0 if fixed-point mode is off)
+double fixedPointResolution();
+
+// REQUIRES: v's coordinates are less than 2^50 times the resolution in
+//           magnitude
+// MODIFIES: v
+// EFFECTS : In fixed-point mode, rounds v's coordinates to the nearest
+//           multiple of the resolution (orientation recovers the multiples
+//           from them). Does nothing otherwise. Every vertex not read by
+//           preProcess (start, goal, generated points) must be snapped
+//           before it is used.
+void snapToGrid(Vertex &v);
 
 // REQUIRES: graph is an empty graph, polygonFile has been opened properly and
 //           contains polygons in the proper format, polygons cannot overlap,
@@ -71,6 +91,34 @@ void preProcess(Graph &graph, std::istream& polygonFile,
                 int &addVerticesCounter, int &makeConnectionsCounter,
                 int &visibleVerticesCounter, int &visibleCounter);
 
+// REQUIRES: polygons contains valid polygons, numbered as read_polygons
+//           numbers them (indices need not be contiguous)
+// MODIFIES: cones
+// EFFECTS : Sets cones to the interior cone of every polygon vertex, indexed
+//           by polygon index and then location, for visible to reject
+//           segments that leave a corner into its own polygon. The table
+//           describes polygons as they are now; build it again after
+//           changing them.
+void findPolygonCones(List<List<Vertex>> const &polygons,
+                      PolygonCones &cones);
+
+// NOTE: preProcess calls this first. It is public so that polygons can be
+//       changed (see simplifyPolygons) before addVertices and makeConnections
+//       build the graph.
+// REQUIRES: polygons is an empty List of polygons, 'is' is a valid
+//           input stream that has been opened and is in the correct format
+// MODIFIES: polygons, is
+// EFFECTS : reads vertices from is and places them into polygons. Adds the
+//           number of loops run to loop counter
+void read_polygons(List<List<Vertex>>& polygons, std::istream& is,
+                   int &loopCounter);
+
+// REQUIRES: polygons contains valid polygon objects
+// MODIFIES: os
+// EFFECTS : Writes polygons to os in the polygon file format read by
+//           preProcess (the caller chooses the precision of os)
+void writePolygons(std::ostream &os, List<List<Vertex>> const &polygons);
+
 // REQUIRES: graph is an empty Graph, polygons contains polygon objects with
 //           coordinates in the correct format
 // MODIFIES: graph
@@ -94,10 +142,11 @@ void makeConnections(Graph &graph, List<List<Vertex>> const &polygons,
 // MODIFIES: graph
 // EFFECTS : adds all possible paths from v that are indexed higher (listed
 //           later) in graph to graph as edges. Adds the number of loops run to
-//           loopCounter
+//           loopCounter. cones, if given, is passed on to visible.
 void visibleVertices(List<Vertex>::Iterator v, Graph &graph,
                      List<List<Vertex>> const &polygons, int &loopCounter,
-                     int &visibleCounter);
+                     int &visibleCounter,
+                     const PolygonCones *cones = nullptr);
 
 // NOTE: This overload is for use when finding the edges added by start and goal
 //       in the visibility graph.
@@ -108,9 +157,11 @@ void visibleVertices(List<Vertex>::Iterator v, Graph &graph,
 // EFFECTS : adds all possible paths from v that are indexed higher (listed
 //           later) in graph to graph as edges. Also adds these edges to victims
 //           for later deletion. Adds the number of loops run to loopCounter.
+//           cones, if given, is passed on to visible.
 void visibleVertices(List<Vertex>::Iterator v, Graph &graph,
                      List<List<Vertex>> const &polygons, int &loopCounter,
-                     int &visibleCounter, List<Edge> &victims);
+                     int &visibleCounter, List<Edge> &victims,
+                     const PolygonCones *cones = nullptr);
 
 // REQUIRES: v and check are valid vertices; v != check;
 //           v and check are not in the interior of a polgon
@@ -118,9 +169,12 @@ void visibleVertices(List<Vertex>::Iterator v, Graph &graph,
 // EFFECTS : returns true if check is visible from v (the line segment
 //           connecting check and v does intersect any polygon edges);
 //           returns false otherwise. Adds the number of loops run to
-//           loopCounter
+//           loopCounter. If cones (see findPolygonCones) is given, segments
+//           that leave an endpoint into its own polygon are rejected before
+//           any edge is tested.
 bool visible(const Vertex& v, const Vertex& check,
-             List<List<Vertex>> const &polygons, int &loopCounter);
+             List<List<Vertex>> const &polygons, int &loopCounter,
+             const PolygonCones *cones = nullptr);
 
 // REQUIRES: all parameters are valid vertices.
 // EFFECTS : returns true if the line segment [a1, a2] intesects line segment
@@ -137,8 +191,25 @@ bool visible(const Vertex& v, const Vertex& check,
 bool intersect(Vertex const& a1, Vertex const& a2,
                Vertex const& b1, Vertex const& b2);
 
-// EFFECTS : Returns true if lhs and rhs have the same coordinates.
-bool operator==(const Vertex &lhs, const Vertex &rhs);
+// REQUIRES: all parameters are valid vertices (snapped in fixed-point mode)
+// EFFECTS : Exact orientation test, the same one intersect uses. Returns 1 if
+//           (p1, p2, p3) turn clockwise, -1 if counterclockwise, 0 if they
+//           are collinear.
+int orientationSign(Vertex const &p1, Vertex const &p2, Vertex const &p3);
+
+// Orientation tests (see intersect) run by one thread, by whether the
+// floating-point filter decided the sign or the exact fallback was needed,
+// and calls to visible rejected by the interior cone of an endpoint before
+// any edge was tested
+struct PredicateCounters {
+    long long fast;
+    long long exact;
+    long long coneRejections;
+};
+
+// EFFECTS : Returns the orientation test counts of the calling thread. They
+//           can be reset by assigning to the result.
+PredicateCounters & predicateCounters();
 
 // REQUIRES: v is a valid Vertex
 // MODIFIES: os
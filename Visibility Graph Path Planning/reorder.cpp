@@ -0,0 +1,164 @@
+//
+//  reorder.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include "reorder.h"
+
+using namespace std;
+
+// EFFECTS : Spreads the low 16 bits of v out to the even bits of the result
+static unsigned long long spreadBits(unsigned v) {
+    unsigned long long x = v & 0xFFFF;
+    x = (x | (x << 8)) & 0x00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0Full;
+    x = (x | (x << 2)) & 0x33333333ull;
+    x = (x | (x << 1)) & 0x55555555ull;
+    return x;
+}
+
+// REQUIRES: x < CURVE_GRID_SIZE, y < CURVE_GRID_SIZE
+// EFFECTS : Returns the position of cell (x, y) along the Morton curve
+unsigned long long mortonKey(unsigned x, unsigned y) {
+    assert(x < CURVE_GRID_SIZE && y < CURVE_GRID_SIZE);
+    return spreadBits(x) | (spreadBits(y) << 1);
+}
+
+// REQUIRES: x < CURVE_GRID_SIZE, y < CURVE_GRID_SIZE
+// EFFECTS : Returns the position of cell (x, y) along the Hilbert curve
+//           Credit: https://en.wikipedia.org/wiki/Hilbert_curve (xy2d)
+unsigned long long hilbertKey(unsigned x, unsigned y) {
+    assert(x < CURVE_GRID_SIZE && y < CURVE_GRID_SIZE);
+    unsigned long long key = 0;
+    for (unsigned s = CURVE_GRID_SIZE / 2; s > 0; s /= 2) {
+        unsigned rx = (x & s) > 0;
+        unsigned ry = (y & s) > 0;
+        key += (unsigned long long) s * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant so the curve inside it starts and ends where
+        // the next level expects
+        if (ry == 0) {
+            if (rx == 1) {
+                x = CURVE_GRID_SIZE - 1 - x;
+                y = CURVE_GRID_SIZE - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return key;
+}
+
+// REQUIRES: low <= value <= high
+// EFFECTS : Returns the grid cell value falls in along an axis from low to
+//           high
+static unsigned gridCell(double value, double low, double high) {
+    if (high <= low) {
+        return 0;
+    }
+    double cell = (value - low) / (high - low) * (CURVE_GRID_SIZE - 1);
+    return (unsigned) (cell + 0.5);
+}
+
+// REQUIRES: graph has been pre-processed and nothing holds pointers to its
+//           vertices or edges (nothing has been built from it yet)
+// MODIFIES: graph, loopCounter
+// EFFECTS : Lays a CURVE_GRID_SIZE grid over the bounding box of graph's
+//           vertices and sorts the vertices by the position of their cell
+//           along the curve for order (ties keep file order). Every vertex
+//           and edge is reallocated in the new order, so consecutive
+//           vertices are also close in memory, and edge endpoints are
+//           remapped to the new vertices. Edges are sorted by their endpoints
+//           in the new order. Vertex data (coordinates and polygon
+//           membership) is unchanged. Does nothing for FILE_ORDER. Adds the
+//           number of vertices and edges moved to loopCounter.
+void reorderVertices(Graph &graph, VertexOrder order, int &loopCounter) {
+    // The curves are laid over the plane
+    static_assert(DIMENSIONS == 2, "curves are laid over the plane");
+    if (order == FILE_ORDER || graph.vertices.empty()) {
+        return;
+    }
+
+    vector<const Vertex*> vertices;
+    vertices.reserve(graph.vertices.size());
+    List<Vertex>::Iterator endV = graph.vertices.end();
+    for (List<Vertex>::Iterator v = graph.vertices.begin(); v != endV; ++v) {
+        vertices.push_back(*v);
+    }
+
+    double low[DIMENSIONS];
+    double high[DIMENSIONS];
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        low[i] = high[i] = vertices[0]->coord[i];
+    }
+    for (int v = 1; v < (int) vertices.size(); ++v) {
+        for (int i = 0; i < DIMENSIONS; ++i) {
+            low[i] = min(low[i], vertices[v]->coord[i]);
+            high[i] = max(high[i], vertices[v]->coord[i]);
+        }
+    }
+
+    // (curve position, file position) pairs, so sorting keeps ties in file
+    // order
+    vector<pair<unsigned long long, int>> keys(vertices.size());
+    for (int v = 0; v < (int) vertices.size(); ++v) {
+        unsigned x = gridCell(vertices[v]->coord[0], low[0], high[0]);
+        unsigned y = gridCell(vertices[v]->coord[1], low[1], high[1]);
+        keys[v].first = order == HILBERT_ORDER ? hilbertKey(x, y)
+                                               : mortonKey(x, y);
+        keys[v].second = v;
+    }
+    sort(keys.begin(), keys.end());
+
+    // Allocate the new vertices back to back in curve order
+    vector<Vertex*> reordered(vertices.size());
+    unordered_map<const Vertex*, int> newIndex;
+    newIndex.reserve(vertices.size());
+    for (int v = 0; v < (int) keys.size(); ++v) {
+        const Vertex *old = vertices[keys[v].second];
+        reordered[v] = new Vertex(*old);
+        newIndex[old] = v;
+        ++loopCounter;
+    }
+
+    // Remap the edges, lower endpoint first
+    struct EdgeEntry {
+        int low;
+        int high;
+        const Edge *edge;
+    };
+    vector<EdgeEntry> edges;
+    edges.reserve(graph.connections.size());
+    List<Edge>::Iterator endE = graph.connections.end();
+    for (List<Edge>::Iterator e = graph.connections.begin(); e != endE; ++e) {
+        int i1 = newIndex.at((*e)->v1);
+        int i2 = newIndex.at((*e)->v2);
+        edges.push_back(EdgeEntry{min(i1, i2), max(i1, i2), *e});
+    }
+    stable_sort(edges.begin(), edges.end(),
+                [](const EdgeEntry &a, const EdgeEntry &b) {
+                    return a.low < b.low ||
+                           (a.low == b.low && a.high < b.high);
+                });
+    vector<Edge*> reorderedEdges(edges.size());
+    for (int e = 0; e < (int) edges.size(); ++e) {
+        const Edge *old = edges[e].edge;
+        reorderedEdges[e] = new Edge{reordered[newIndex.at(old->v1)],
+                                     reordered[newIndex.at(old->v2)],
+                                     old->length};
+        ++loopCounter;
+    }
+
+    // Swap the new vertices and edges in (graph owns both, so the old ones
+    // are deleted as they are removed)
+    graph.connections.removeIf([](Edge *) { return true; });
+    graph.vertices.removeIf([](Vertex *) { return true; });
+    for (int v = 0; v < (int) reordered.size(); ++v) {
+        graph.vertices.insertEnd(reordered[v]);
+    }
+    for (int e = 0; e < (int) reorderedEdges.size(); ++e) {
+        graph.connections.insertEnd(reorderedEdges[e]);
+    }
+}
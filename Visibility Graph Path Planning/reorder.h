@@ -0,0 +1,53 @@
+//
+//  reorder.h
+//  Visibility Graph Path Planning
+//
+//  Renumbers the vertices of a pre-processed graph along a space-filling
+//  curve. read_polygons and addVertices leave the vertices in file order, so
+//  vertices that are close in the plane (the ones a search visits together)
+//  can be far apart in the vertex list and in memory. Sorting them by their
+//  position along a Hilbert or Morton (Z-order) curve keeps neighbors close
+//  in both.
+//
+
+#ifndef reorder_h
+#define reorder_h
+
+#include "preprocessing.h"
+
+// Vertex orders reorderVertices can produce
+enum VertexOrder {
+    // Order read from the polygon file (no reordering)
+    FILE_ORDER,
+    // Z-order curve: interleaved coordinate bits
+    MORTON_ORDER,
+    // Hilbert curve: like Morton, but consecutive cells always touch
+    HILBERT_ORDER
+};
+
+// Side of the square grid the curves are laid over, in cells (2^16)
+const unsigned CURVE_GRID_SIZE = 1u << 16;
+
+// REQUIRES: x < CURVE_GRID_SIZE, y < CURVE_GRID_SIZE
+// EFFECTS : Returns the position of cell (x, y) along the Morton curve
+unsigned long long mortonKey(unsigned x, unsigned y);
+
+// REQUIRES: x < CURVE_GRID_SIZE, y < CURVE_GRID_SIZE
+// EFFECTS : Returns the position of cell (x, y) along the Hilbert curve
+unsigned long long hilbertKey(unsigned x, unsigned y);
+
+// REQUIRES: graph has been pre-processed and nothing holds pointers to its
+//           vertices or edges (nothing has been built from it yet)
+// MODIFIES: graph, loopCounter
+// EFFECTS : Lays a CURVE_GRID_SIZE grid over the bounding box of graph's
+//           vertices and sorts the vertices by the position of their cell
+//           along the curve for order (ties keep file order). Every vertex
+//           and edge is reallocated in the new order, so consecutive
+//           vertices are also close in memory, and edge endpoints are
+//           remapped to the new vertices. Edges are sorted by their endpoints
+//           in the new order. Vertex data (coordinates and polygon
+//           membership) is unchanged. Does nothing for FILE_ORDER. Adds the
+//           number of vertices and edges moved to loopCounter.
+void reorderVertices(Graph &graph, VertexOrder order, int &loopCounter);
+
+#endif /* reorder_h */
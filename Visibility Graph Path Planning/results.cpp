@@ -0,0 +1,44 @@
+//
+//  results.cpp
+//  Visibility Graph Path Planning
+//
+
+#include "results.h"
+
+using namespace std;
+
+// MODIFIES: os
+// EFFECTS : Writes the column names of both record types as '#' lines
+void writeResultsHeader(std::ostream &os) {
+    os << "#graph,test,polygons,vertices,generation_clocks,graph_vertices,"
+          "graph_edges,read_polygons_loops,add_vertices_loops,"
+          "make_connections_loops,visible_vertices_loops,visible_loops,"
+          "preprocess_clocks\n";
+    os << "#search,test,search,success,direct,distance,graph_vertices,"
+          "graph_edges,nodes_expanded,search_clocks,max_tree_size,"
+          "memory_bytes\n";
+}
+
+// MODIFIES: os
+// EFFECTS : Writes record as a "graph" row
+void writeGraphRecord(std::ostream &os, const GraphRecord &record) {
+    // Rows end with '\n' rather than endl, so the stream is not flushed
+    // after every row
+    os << "graph," << record.test << ',' << record.polygons << ','
+       << record.vertices << ',' << record.generationClocks << ','
+       << record.graphVertices << ',' << record.graphEdges << ','
+       << record.readPolygonsLoops << ',' << record.addVerticesLoops << ','
+       << record.makeConnectionsLoops << ',' << record.visibleVerticesLoops
+       << ',' << record.visibleLoops << ',' << record.preprocessClocks
+       << '\n';
+}
+
+// MODIFIES: os
+// EFFECTS : Writes record as a "search" row
+void writeSearchRecord(std::ostream &os, const SearchRecord &record) {
+    os << "search," << record.test << ',' << record.search << ','
+       << record.success << ',' << record.direct << ',' << record.distance
+       << ',' << record.graphVertices << ',' << record.graphEdges << ','
+       << record.nodesExpanded << ',' << record.searchClocks << ','
+       << record.maxTreeSize << ',' << record.memoryBytes << '\n';
+}
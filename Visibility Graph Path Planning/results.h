@@ -0,0 +1,69 @@
+//
+//  results.h
+//  Visibility Graph Path Planning
+//
+//  Fixed-schema CSV records of the testing results, written next to (or
+//  instead of) the free-form text in "output.out". Every row starts with its
+//  record type, and the columns of each type never change, so tools can read
+//  the file in one streaming pass without searching for labels. The first
+//  lines of the file start with '#' and name the columns.
+//
+
+#ifndef results_h
+#define results_h
+
+#include <iostream>
+#include <cstddef>
+
+// Preprocessing results of one test ("graph" rows)
+struct GraphRecord {
+    int test;
+    // Polygons and polygon vertices generated
+    int polygons;
+    int vertices;
+    long generationClocks;
+    // Visibility graph size (without start and goal)
+    int graphVertices;
+    int graphEdges;
+    // Loops run by each preprocessing function (see preProcess)
+    int readPolygonsLoops;
+    int addVerticesLoops;
+    int makeConnectionsLoops;
+    int visibleVerticesLoops;
+    int visibleLoops;
+    long preprocessClocks;
+};
+
+// Results of one search ("search" rows)
+struct SearchRecord {
+    int test;
+    int search;
+    // 1 if a path was found
+    int success;
+    // 1 if start could see goal, so A* was not needed (the remaining
+    // columns are then 0)
+    int direct;
+    // Path length (-1 on failure)
+    double distance;
+    // Graph size with start and goal attached
+    int graphVertices;
+    int graphEdges;
+    int nodesExpanded;
+    long searchClocks;
+    int maxTreeSize;
+    size_t memoryBytes;
+};
+
+// MODIFIES: os
+// EFFECTS : Writes the column names of both record types as '#' lines
+void writeResultsHeader(std::ostream &os);
+
+// MODIFIES: os
+// EFFECTS : Writes record as a "graph" row
+void writeGraphRecord(std::ostream &os, const GraphRecord &record);
+
+// MODIFIES: os
+// EFFECTS : Writes record as a "search" row
+void writeSearchRecord(std::ostream &os, const SearchRecord &record);
+
+#endif /* results_h */
@@ -0,0 +1,191 @@
+//
+//  search_context.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <algorithm>
+#include "search_context.h"
+#include "trace.h"
+
+using namespace std;
+
+// EFFECTS : Returns true if node a leaves the open list before node b
+bool SearchContext::before(int a, int b) const {
+    return nodes[a].fCost < nodes[b].fCost ||
+           (nodes[a].fCost == nodes[b].fCost && a < b);
+}
+
+// MODIFIES: this
+// EFFECTS : Adds node to the open list
+void SearchContext::pushOpen(int node) {
+    int hole = (int) open.size();
+    open.push_back(node);
+    // Sift up
+    while (hole > 0) {
+        int parent = (hole - 1) / 2;
+        if (!before(node, open[parent])) {
+            break;
+        }
+        open[hole] = open[parent];
+        hole = parent;
+    }
+    open[hole] = node;
+}
+
+// REQUIRES: the open list is not empty
+// MODIFIES: this
+// EFFECTS : Removes and returns the first node of the open list
+int SearchContext::popOpen() {
+    assert(!open.empty());
+    const int top = open[0];
+    const int last = open.back();
+    open.pop_back();
+    const int size = (int) open.size();
+    if (size == 0) {
+        return top;
+    }
+
+    // Sift the last node down from the root
+    int hole = 0;
+    while (2 * hole + 1 < size) {
+        int child = 2 * hole + 1;
+        if (child + 1 < size && before(open[child + 1], open[child])) {
+            ++child;
+        }
+        if (!before(open[child], last)) {
+            break;
+        }
+        open[hole] = open[child];
+        hole = child;
+    }
+    open[hole] = last;
+    return top;
+}
+
+// MODIFIES: this
+// EFFECTS : Adds a node for s (with the given parent and costs) and
+//           returns true, unless a node for s was already generated in
+//           this query, in which case returns false
+bool SearchContext::generate(const State &s, int parent, double pathCost,
+                             double fCost) {
+    // The table is a power of two, at least twice the number of states
+    const size_t mask = slotNodes.size() - 1;
+    size_t slot = StateHash()(s) & mask;
+    while (slotStamps[slot] == stamp) {
+        if (nodes[slotNodes[slot]].state == s) {
+            return false;
+        }
+        slot = (slot + 1) & mask;
+    }
+    slotStamps[slot] = stamp;
+    slotNodes[slot] = (int) nodes.size();
+    nodes.push_back(Node{s, parent, pathCost, fCost});
+    return true;
+}
+
+// EFFECTS : Constructs a context with no buffers
+SearchContext::SearchContext()
+: stamp(0) {}
+
+// MODIFIES: this
+// EFFECTS : Grows the buffers to hold a search of numStates states and
+//           clears them for a new query
+void SearchContext::reserve(int numStates) {
+    // Every state gets at most one node, and so one slot and one open entry
+    size_t tableSize = 1;
+    while (tableSize < 2 * (size_t) max(numStates, 1)) {
+        tableSize *= 2;
+    }
+    if (slotNodes.size() < tableSize) {
+        slotNodes.assign(tableSize, 0);
+        slotStamps.assign(tableSize, 0);
+        stamp = 0;
+    }
+    nodes.reserve(numStates);
+    open.reserve(numStates);
+    // A state has at most one successor per state
+    possibleStates.reserve(numStates);
+    pathCosts.reserve(numStates);
+
+    nodes.clear();
+    open.clear();
+    // Start a new stamp, wiping the stamps when they run out
+    if (++stamp == 0) {
+        fill(slotStamps.begin(), slotStamps.end(), 0);
+        stamp = 1;
+    }
+}
+
+// REQUIRES: p is a valid Problem, solution is empty, epsilon >= 1
+// MODIFIES: this, solution, nodesExpanded, maxNodes
+// EFFECTS : Same search as AStarSearch (the same nodes are expanded in
+//           the same order), using this context's buffers. solution
+//           becomes the path from FINISH to START, or stays empty on
+//           failure. nodesExpanded is incremented by the number of nodes
+//           expanded, and maxNodes is set to the number of nodes
+//           generated. Returns the path cost of the solution, or -1 on
+//           failure. Allocates only when a buffer (or solution) must grow
+//           past what earlier queries needed.
+double SearchContext::search(const Problem &p, vector<State> &solution,
+                             int &nodesExpanded, int &maxNodes,
+                             double epsilon) {
+    TraceScope trace("context search");
+    // Check requires clause
+    assert(solution.empty());
+    assert(epsilon >= 1);
+
+    reserve(p.numStates());
+
+    const State start = p.getStartState();
+    generate(start, -1, 0, p.heuristic(start));
+    pushOpen(0);
+
+    // Like AStarSearch, a state is generated at most once: states already
+    // on the open list or expanded are skipped
+    while (!open.empty()) {
+        const int current = popOpen();
+        const Node node = nodes[current];
+
+        if (p.goalTest(node.state)) {
+            // Found solution! Walk back to the root.
+            for (int n = current; n != -1; n = nodes[n].parent) {
+                solution.push_back(nodes[n].state);
+            }
+            maxNodes = (int) nodes.size();
+            return node.pathCost;
+        }
+
+        ++nodesExpanded;
+        possibleStates.clear();
+        pathCosts.clear();
+        p.expandOptions(possibleStates, pathCosts, node.state);
+        for (int i = 0; i < (int) possibleStates.size(); ++i) {
+            double newPathCost = node.pathCost + pathCosts[i];
+            double newFCost = newPathCost +
+                              epsilon * p.heuristic(possibleStates[i]);
+            if (generate(possibleStates[i], current, newPathCost, newFCost)) {
+                pushOpen((int) nodes.size() - 1);
+            }
+        }
+    }
+
+    // Failure
+    maxNodes = (int) nodes.size();
+    return -1;
+}
+
+// EFFECTS : Returns the bytes held by the buffers
+size_t SearchContext::memory() const {
+    return nodes.capacity() * sizeof(Node) + open.capacity() * sizeof(int) +
+           slotNodes.capacity() * sizeof(int) +
+           slotStamps.capacity() * sizeof(unsigned) +
+           possibleStates.capacity() * sizeof(State) +
+           pathCosts.capacity() * sizeof(double);
+}
+
+// EFFECTS : Returns the calling thread's context, created on first use
+SearchContext & threadSearchContext() {
+    static thread_local SearchContext context;
+    return context;
+}
@@ -0,0 +1,97 @@
+//
+//  search_context.h
+//  Visibility Graph Path Planning
+//
+//  Reusable buffers for repeated A* queries. AStarSearch builds a new Tree,
+//  open list and closed list for every query, and allocates every node, list
+//  entry and successor vector on the way. A SearchContext keeps its nodes in
+//  a vector, its open list in a binary heap and the states it has generated
+//  in an open addressing table, all sized to the largest graph searched so
+//  far and only cleared between queries, so once it has warmed up a query
+//  makes no heap allocations. Each thread should use its own context (see
+//  threadSearchContext).
+//
+
+#ifndef search_context_h
+#define search_context_h
+
+#include <vector>
+#include <cstddef>
+#include "AStarProblem.h"
+
+class SearchContext {
+private:
+    // Search node; nodes are numbered in the order they are generated
+    struct Node {
+        State state;
+        // Number of the node this one was generated from (-1 for the root)
+        int parent;
+        double pathCost;
+        double fCost;
+    };
+    std::vector<Node> nodes;
+
+    // Binary heap of node numbers, ordered by fCost and then by node number,
+    // so nodes with equal fCosts leave in the order they were generated (as
+    // in AStarSearch's sorted open list)
+    std::vector<int> open;
+
+    // Open addressing table (linear probing) of the nodes generated in this
+    // query, by state. A slot is in use if its stamp is the query's stamp,
+    // so clearing the table is one increment.
+    std::vector<int> slotNodes;
+    std::vector<unsigned> slotStamps;
+    unsigned stamp;
+
+    // Filled by Problem::expandOptions
+    std::vector<State> possibleStates;
+    std::vector<double> pathCosts;
+
+    // EFFECTS : Returns true if node a leaves the open list before node b
+    bool before(int a, int b) const;
+
+    // MODIFIES: this
+    // EFFECTS : Adds node to the open list
+    void pushOpen(int node);
+
+    // REQUIRES: the open list is not empty
+    // MODIFIES: this
+    // EFFECTS : Removes and returns the first node of the open list
+    int popOpen();
+
+    // MODIFIES: this
+    // EFFECTS : Adds a node for s (with the given parent and costs) and
+    //           returns true, unless a node for s was already generated in
+    //           this query, in which case returns false
+    bool generate(const State &s, int parent, double pathCost, double fCost);
+
+public:
+    // EFFECTS : Constructs a context with no buffers
+    SearchContext();
+
+    // MODIFIES: this
+    // EFFECTS : Grows the buffers to hold a search of numStates states and
+    //           clears them for a new query
+    void reserve(int numStates);
+
+    // REQUIRES: p is a valid Problem, solution is empty, epsilon >= 1
+    // MODIFIES: this, solution, nodesExpanded, maxNodes
+    // EFFECTS : Same search as AStarSearch (the same nodes are expanded in
+    //           the same order), using this context's buffers. solution
+    //           becomes the path from FINISH to START, or stays empty on
+    //           failure. nodesExpanded is incremented by the number of nodes
+    //           expanded, and maxNodes is set to the number of nodes
+    //           generated. Returns the path cost of the solution, or -1 on
+    //           failure. Allocates only when a buffer (or solution) must grow
+    //           past what earlier queries needed.
+    double search(const Problem &p, std::vector<State> &solution,
+                  int &nodesExpanded, int &maxNodes, double epsilon = 1);
+
+    // EFFECTS : Returns the bytes held by the buffers
+    size_t memory() const;
+};
+
+// EFFECTS : Returns the calling thread's context, created on first use
+SearchContext & threadSearchContext();
+
+#endif /* search_context_h */
@@ -0,0 +1,97 @@
+//
+//  search_context_test.cpp
+//  Visibility Graph Path Planning
+//
+//  Checks that a warmed-up SearchContext answers queries without heap
+//  allocations, and with the same results as AStarSearch. Built with
+//  allocation_counter.cpp, which replaces the global operator new for this
+//  program only ("make test" builds and runs it).
+//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include "preprocessing.h"
+#include "map_generator.h"
+#include "AStarProblem.h"
+#include "search_functions.h"
+#include "search_context.h"
+#include "allocation_counter.h"
+
+using namespace std;
+
+// Map and queries of the test
+static const unsigned MAPSEED = 2017;
+static const int NUMPOLYGONS = 40;
+static const int MAXVERTICES = 8;
+static const int NUMQUERIES = 25;
+
+int main() {
+    // Build a visibility graph of a seeded random map
+    MapGenerator generator(MAPSEED, 100);
+    generator.generate(NUMPOLYGONS, MAXVERTICES, 100000);
+    List<List<Vertex>> polygons(true);
+    Graph graph;
+    int dummyCounter = 0;
+    generator.toPolygons(polygons, dummyCounter);
+    addVertices(graph, polygons, dummyCounter);
+    makeConnections(graph, polygons, dummyCounter, dummyCounter,
+                    dummyCounter);
+
+    vector<const Vertex*> vertices;
+    List<Vertex>::Iterator end = graph.vertices.end();
+    for (List<Vertex>::Iterator v = graph.vertices.begin(); v != end; ++v) {
+        vertices.push_back(*v);
+    }
+    const int numVertices = (int) vertices.size();
+
+    // Queries between different pairs of polygon vertices, fixed up front so
+    // the timed loop does not allocate
+    vector<Problem> problems;
+    problems.reserve(NUMQUERIES);
+    for (int i = 0; i < NUMQUERIES; ++i) {
+        State start = {vertices[(i * 7) % numVertices]};
+        State goal = {vertices[(i * 13 + numVertices / 2) % numVertices]};
+        problems.push_back(Problem(graph, start, goal));
+    }
+    vector<double> distances(NUMQUERIES);
+    vector<int> expanded(NUMQUERIES);
+    vector<State> solution;
+    solution.reserve(numVertices);
+
+    // Warm the context with one query, then run all of them
+    SearchContext context;
+    int nodesExpanded = 0;
+    int maxNodes = 0;
+    context.search(problems[0], solution, nodesExpanded, maxNodes);
+
+    const long allocationsBefore = allocationCount();
+    for (int i = 0; i < NUMQUERIES; ++i) {
+        solution.clear();
+        expanded[i] = 0;
+        distances[i] = context.search(problems[i], solution, expanded[i],
+                                      maxNodes);
+    }
+    const long allocations = allocationCount() - allocationsBefore;
+
+    // The same searches as AStarSearch
+    int mismatches = 0;
+    for (int i = 0; i < NUMQUERIES; ++i) {
+        vector<State> expected;
+        int expectedExpanded = 0;
+        int maxTreeSize = 0;
+        size_t memoryUse = 0;
+        double expectedDistance = AStarSearch(problems[i], expected,
+                                              expectedExpanded, maxTreeSize,
+                                              memoryUse);
+        if (expectedExpanded != expanded[i] ||
+            fabs(expectedDistance - distances[i]) > 1e-9) {
+            ++mismatches;
+        }
+    }
+
+    cout << "search_context_test: " << NUMQUERIES << " queries on "
+         << numVertices << " vertices, " << allocations << " allocations, "
+         << mismatches << " differing from AStarSearch" << endl;
+    return (allocations == 0 && mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,391 @@
+//
+//  search_engine.h
+//  Visibility Graph Path Planning
+//
+//  Header-only A* search, specialized at compile time on the problem type and
+//  on how the open list, closed set and search nodes are stored. Everything
+//  the main loop calls is visible to the compiler, so heuristic, goal test and
+//  successor generation can be inlined, and a workload can swap a heap or a
+//  set without touching the search.
+//
+//  A problem type provides:
+//      StateType        (copyable, with operator==)
+//      StateHasher      (hash function object for StateType)
+//      StateType startState() const;
+//      bool isGoal(const StateType &s) const;
+//      double heuristic(const StateType &s) const;
+//      template <class Visit>
+//      void forEachSuccessor(const StateType &s, Visit visit) const;
+//          (calls visit(successor, edgeCost) for every successor of s)
+//  and, for IndexedNodeStorage only:
+//      int numStates() const;
+//      int stateIndex(const StateType &s) const;  (0 <= index < numStates())
+//
+//  Unlike AStarSearch, a state already on the open list is updated when a
+//  shorter path to it is found (by pushing it again and skipping the stale
+//  entry later), so the path found is optimal for a consistent heuristic.
+//
+
+#ifndef search_engine_h
+#define search_engine_h
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+
+// One search node. Nodes are numbered by the node storage policy and refer to
+// their parent by number.
+template <class StateType>
+struct SearchNode {
+    StateType state;
+    // Number of the node this one was reached from (-1 for the root)
+    int parent;
+    // Cost of the best path found to this node (infinity if none yet)
+    double pathCost;
+};
+
+// Entry in an open list
+struct OpenEntry {
+    double fCost;
+    int node;
+};
+
+////////////// Open list policies //////////////////////
+//
+// void push(double fCost, int node);
+// bool empty() const;
+// int pop();   (removes and returns the node with the smallest fCost)
+// int size() const;
+
+// Implicit heap with Arity children per entry. Wider heaps are shallower,
+// trading more comparisons per level for fewer levels (and cache misses).
+template <int Arity>
+class DAryHeapOpen {
+private:
+    std::vector<OpenEntry> heap;
+
+public:
+    // EFFECTS : Adds node to the heap with key fCost
+    void push(double fCost, int node) {
+        int hole = (int) heap.size();
+        heap.push_back(OpenEntry{fCost, node});
+        // Sift up
+        while (hole > 0) {
+            int parent = (hole - 1) / Arity;
+            if (heap[parent].fCost <= fCost) {
+                break;
+            }
+            heap[hole] = heap[parent];
+            hole = parent;
+        }
+        heap[hole] = OpenEntry{fCost, node};
+    }
+
+    // EFFECTS : Returns true if the heap is empty
+    bool empty() const {
+        return heap.empty();
+    }
+
+    // REQUIRES: the heap is not empty
+    // EFFECTS : Removes and returns the node with the smallest key
+    int pop() {
+        assert(!heap.empty());
+        const int top = heap[0].node;
+        const OpenEntry last = heap.back();
+        heap.pop_back();
+        const int size = (int) heap.size();
+        if (size == 0) {
+            return top;
+        }
+
+        // Sift the last entry down from the root
+        int hole = 0;
+        while (true) {
+            int first = hole * Arity + 1;
+            if (first >= size) {
+                break;
+            }
+            int smallest = first;
+            int end = std::min(first + Arity, size);
+            for (int child = first + 1; child < end; ++child) {
+                if (heap[child].fCost < heap[smallest].fCost) {
+                    smallest = child;
+                }
+            }
+            if (last.fCost <= heap[smallest].fCost) {
+                break;
+            }
+            heap[hole] = heap[smallest];
+            hole = smallest;
+        }
+        heap[hole] = last;
+        return top;
+    }
+
+    // EFFECTS : Returns the number of entries (including stale ones)
+    int size() const {
+        return (int) heap.size();
+    }
+};
+
+typedef DAryHeapOpen<2> BinaryHeapOpen;
+typedef DAryHeapOpen<4> QuaternaryHeapOpen;
+
+// Linked list kept sorted by fCost, like the open list of AStarSearch: O(1)
+// pop, O(n) push
+class SortedListOpen {
+private:
+    std::list<OpenEntry> entries;
+
+public:
+    // EFFECTS : Inserts node after every entry with a key <= fCost
+    void push(double fCost, int node) {
+        std::list<OpenEntry>::iterator it = entries.begin();
+        while (it != entries.end() && it->fCost <= fCost) {
+            ++it;
+        }
+        entries.insert(it, OpenEntry{fCost, node});
+    }
+
+    // EFFECTS : Returns true if the list is empty
+    bool empty() const {
+        return entries.empty();
+    }
+
+    // REQUIRES: the list is not empty
+    // EFFECTS : Removes and returns the node with the smallest key
+    int pop() {
+        assert(!entries.empty());
+        int top = entries.front().node;
+        entries.pop_front();
+        return top;
+    }
+
+    // EFFECTS : Returns the number of entries (including stale ones)
+    int size() const {
+        return (int) entries.size();
+    }
+};
+
+////////////// Closed set policies //////////////////////
+//
+// explicit ClosedSet(const Problem &p);
+// bool contains(int node, const StateType &s) const;
+// void insert(int node, const StateType &s);
+
+// Hash set of closed states
+template <class Problem>
+class HashClosedSet {
+private:
+    typedef typename Problem::StateType StateType;
+    std::unordered_set<StateType, typename Problem::StateHasher> closed;
+
+public:
+    explicit HashClosedSet(const Problem &) {}
+
+    bool contains(int, const StateType &s) const {
+        return closed.count(s) != 0;
+    }
+
+    void insert(int, const StateType &s) {
+        closed.insert(s);
+    }
+};
+
+// Unsorted vector of closed states searched linearly, like the closed list of
+// AStarSearch
+template <class Problem>
+class VectorClosedSet {
+private:
+    typedef typename Problem::StateType StateType;
+    std::vector<StateType> closed;
+
+public:
+    explicit VectorClosedSet(const Problem &) {}
+
+    bool contains(int, const StateType &s) const {
+        return std::find(closed.begin(), closed.end(), s) != closed.end();
+    }
+
+    void insert(int, const StateType &s) {
+        closed.push_back(s);
+    }
+};
+
+// One flag per node number. Works with any node storage, since every state
+// has exactly one node number.
+template <class Problem>
+class NodeFlagClosedSet {
+private:
+    typedef typename Problem::StateType StateType;
+    std::vector<char> closed;
+
+public:
+    explicit NodeFlagClosedSet(const Problem &) {}
+
+    bool contains(int node, const StateType &) const {
+        return node < (int) closed.size() && closed[node];
+    }
+
+    void insert(int node, const StateType &) {
+        if (node >= (int) closed.size()) {
+            closed.resize(std::max(node + 1, 2 * (int) closed.size()), 0);
+        }
+        closed[node] = 1;
+    }
+};
+
+////////////// Node storage policies //////////////////////
+//
+// explicit NodeStorage(const Problem &p);
+// int nodeFor(const StateType &s);   (creates the node if it does not exist,
+//                                     with parent -1 and infinite pathCost)
+// SearchNode<StateType> & operator[](int node);   (valid until nodeFor)
+// int size() const;   (number of nodes created)
+
+// Nodes in creation order, found by a hash map from state to node number
+template <class Problem>
+class HashNodeStorage {
+private:
+    typedef typename Problem::StateType StateType;
+    std::vector<SearchNode<StateType>> nodes;
+    std::unordered_map<StateType, int, typename Problem::StateHasher> numbers;
+
+public:
+    explicit HashNodeStorage(const Problem &) {}
+
+    int nodeFor(const StateType &s) {
+        typename std::unordered_map<StateType, int,
+            typename Problem::StateHasher>::iterator found = numbers.find(s);
+        if (found != numbers.end()) {
+            return found->second;
+        }
+        int node = (int) nodes.size();
+        numbers.insert(std::make_pair(s, node));
+        nodes.push_back(SearchNode<StateType>{
+            s, -1, std::numeric_limits<double>::infinity()});
+        return node;
+    }
+
+    SearchNode<StateType> & operator[](int node) {
+        return nodes[node];
+    }
+
+    int size() const {
+        return (int) nodes.size();
+    }
+};
+
+// One node per state, numbered by Problem::stateIndex. No hashing, but takes
+// memory for every state up front.
+template <class Problem>
+class IndexedNodeStorage {
+private:
+    typedef typename Problem::StateType StateType;
+    const Problem &problem;
+    std::vector<SearchNode<StateType>> nodes;
+    int created;
+
+public:
+    explicit IndexedNodeStorage(const Problem &p) :
+    problem(p), nodes(p.numStates()), created(0) {
+        for (int i = 0; i < (int) nodes.size(); ++i) {
+            nodes[i].parent = -2;
+        }
+    }
+
+    int nodeFor(const StateType &s) {
+        int node = problem.stateIndex(s);
+        // parent -2 marks a node that has not been created yet
+        if (nodes[node].parent == -2) {
+            nodes[node] = SearchNode<StateType>{
+                s, -1, std::numeric_limits<double>::infinity()};
+            ++created;
+        }
+        return node;
+    }
+
+    SearchNode<StateType> & operator[](int node) {
+        return nodes[node];
+    }
+
+    int size() const {
+        return created;
+    }
+};
+
+////////////// Search //////////////////////
+
+// REQUIRES: p satisfies the problem requirements above (plus numStates and
+//           stateIndex if NodeStorage is IndexedNodeStorage), solution is
+//           empty
+// MODIFIES: solution, nodesExpanded, maxNodes
+// EFFECTS : A* search on p. solution becomes the path from FINISH to START
+//           (the order AStarSearch uses), or stays empty on failure.
+//           nodesExpanded is incremented by the number of nodes expanded.
+//           maxNodes is set to the number of search nodes created. Returns
+//           the path cost of the solution, or -1 on failure.
+//           Usage: policySearch<BinaryHeapOpen, HashClosedSet,
+//                               HashNodeStorage>(p, solution, ...)
+template <class OpenList, template <class> class ClosedSet,
+          template <class> class NodeStorage, class Problem>
+double policySearch(const Problem &p,
+                    std::vector<typename Problem::StateType> &solution,
+                    int &nodesExpanded, int &maxNodes) {
+    typedef typename Problem::StateType StateType;
+    assert(solution.empty());
+
+    NodeStorage<Problem> nodes(p);
+    ClosedSet<Problem> closed(p);
+    OpenList open;
+
+    const StateType start = p.startState();
+    const int root = nodes.nodeFor(start);
+    nodes[root].pathCost = 0;
+    open.push(p.heuristic(start), root);
+
+    while (!open.empty()) {
+        const int current = open.pop();
+        const StateType state = nodes[current].state;
+        // Skip entries left behind when a node was pushed again
+        if (closed.contains(current, state)) {
+            continue;
+        }
+
+        if (p.isGoal(state)) {
+            // Found solution! Walk back to the root.
+            for (int node = current; node != -1; node = nodes[node].parent) {
+                solution.push_back(nodes[node].state);
+            }
+            maxNodes = nodes.size();
+            return nodes[current].pathCost;
+        }
+
+        closed.insert(current, state);
+        ++nodesExpanded;
+
+        const double pathCost = nodes[current].pathCost;
+        p.forEachSuccessor(state, [&](const StateType &next, double cost) {
+            const int child = nodes.nodeFor(next);
+            if (closed.contains(child, next)) {
+                return;
+            }
+            const double newPathCost = pathCost + cost;
+            if (newPathCost < nodes[child].pathCost) {
+                nodes[child].pathCost = newPathCost;
+                nodes[child].parent = current;
+                open.push(newPathCost + p.heuristic(next), child);
+            }
+        });
+    }
+
+    // Failure
+    maxNodes = nodes.size();
+    return -1;
+}
+
+#endif /* search_engine_h */
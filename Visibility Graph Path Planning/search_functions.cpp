@@ -7,11 +7,19 @@
 //
 
 #include <vector>
+#include <deque>
+#include <queue>
+#include <functional>
+#include <unordered_map>
+#include <limits>
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include "search_functions.h"
 #include "Tree_Node.h"
 #include "Tree.h"
 #include "List.h"
+#include "trace.h"
 
 using namespace std;
 
@@ -93,20 +101,23 @@ static size_t getCurrentRSS( )
 }
 
 
-// REQUIRES: p is a valid Problem, solution is empty
-// MODIFIES: solution
-// EFFECTS : Performs an A-star search on the provided problem.
-//           solution becomes empty vector if failure, solution path if success
-//           nodesExpanded is incremented by the number of nodes expanded during
-//              the A* search
-//           maxTreeSize is set to the maximum number of nodes held at one time
-//           memoryUse is set to the current physical memory usage at the end of
-//              A* search, in bytes
-//           returns the path cost of the solution if success, -1 if failure
-double AStarSearch(const Problem &p, std::vector<State> &solution,
-                   int &nodesExpanded, int &maxTreeSize, size_t &memoryUse) {
+// The clock is only read once every this many expansions
+static const int DEADLINE_CHECK_INTERVAL = 16;
+
+// REQUIRES: p is a valid Problem, solution is empty, epsilon >= 1
+// MODIFIES: solution, distance, nodesExpanded, maxTreeSize, memoryUse
+// EFFECTS : Weighted A* search that stops when budget runs out. Shared by
+//           AStarSearch and budgetedAStarSearch (see those for details).
+static SearchStatus searchWithBudget(const Problem &p,
+                                     const SearchBudget &budget,
+                                     double epsilon,
+                                     std::vector<State> &solution,
+                                     double &distance, int &nodesExpanded,
+                                     int &maxTreeSize, size_t &memoryUse) {
+    TraceScope trace("AStarSearch");
     // Check requires clause
     assert(solution.empty());
+    assert(epsilon >= 1);
     
     // Create tree, open list, and closed list
     auto rootPtr = p.getRootNode();
@@ -118,8 +129,35 @@ double AStarSearch(const Problem &p, std::vector<State> &solution,
     
     vector<State> closedList;
     
+    int budgetExpansions = 0;
+    
     // Continue searching while open list is not empty
     while (!openList.empty()) {
+        // Check the budget before committing to another expansion
+        if ((budget.cancel != nullptr &&
+             budget.cancel->load(memory_order_relaxed)) ||
+            (budget.maxExpansions > 0 &&
+             budgetExpansions >= budget.maxExpansions) ||
+            (budget.deadline != chrono::steady_clock::time_point() &&
+             budgetExpansions % DEADLINE_CHECK_INTERVAL == 0 &&
+             chrono::steady_clock::now() > budget.deadline)) {
+            // Best effort: the open node that looks closest to the goal
+            Tree_Node* closest = nullptr;
+            double closestHeuristic = 0;
+            auto end = openList.end();
+            for (auto it = openList.begin(); it != end; ++it) {
+                double h = p.heuristic((*it)->state);
+                if (closest == nullptr || h < closestHeuristic) {
+                    closest = *it;
+                    closestHeuristic = h;
+                }
+            }
+            findSoln(mainTree, closest, solution);
+            distance = closest->pathCost;
+            memoryUse = getCurrentRSS();
+            return SEARCH_BUDGET_HIT;
+        }
+        
         // Grab next node to check (smallest f-cost always at start)
         Tree_Node* nodeChoice = openList.removeStart();
         
@@ -127,29 +165,286 @@ double AStarSearch(const Problem &p, std::vector<State> &solution,
             // Found solution!
             findSoln(mainTree, nodeChoice, solution);
             memoryUse = getCurrentRSS();
-            return nodeChoice->pathCost;
+            distance = nodeChoice->pathCost;
+            return SEARCH_FOUND;
         }
         
         // Add node choice to closed list now to avoid allowing path to itself
         closedList.push_back(nodeChoice->state);
         
         ++nodesExpanded;
-        expand(p, mainTree, closedList, openList, nodeChoice, maxTreeSize);
+        ++budgetExpansions;
+        expand(p, mainTree, closedList, openList, nodeChoice, maxTreeSize,
+               epsilon);
     }
     
     // Failure
     memoryUse = getCurrentRSS();
-    return -1;
+    distance = -1;
+    return SEARCH_EXHAUSTED;
+}
+
+// REQUIRES: p is a valid Problem, solution is empty
+// MODIFIES: solution
+// EFFECTS : Performs an A-star search on the provided problem.
+//           solution becomes empty vector if failure, solution path if success
+//           nodesExpanded is incremented by the number of nodes expanded during
+//              the A* search
+//           maxTreeSize is set to the maximum number of nodes held at one time
+//           memoryUse is set to the current physical memory usage at the end of
+//              A* search, in bytes
+//           returns the path cost of the solution if success, -1 if failure
+double AStarSearch(const Problem &p, std::vector<State> &solution,
+                   int &nodesExpanded, int &maxTreeSize, size_t &memoryUse) {
+    return AStarSearch(p, solution, nodesExpanded, maxTreeSize, memoryUse, 1);
+}
+
+// REQUIRES: p is a valid Problem, solution is empty, epsilon >= 1
+// MODIFIES: solution
+// EFFECTS : Same as above, but orders the open list by
+//           pathCost + epsilon * heuristic (weighted A*), which usually
+//           expands fewer nodes for a longer path. A state keeps the first
+//           path found to it, even if a cheaper one turns up while it is
+//           open, so no bound on the solution cost is guaranteed (use
+//           anytimeSearch for one). epsilon = 1 is a regular A* search.
+double AStarSearch(const Problem &p, std::vector<State> &solution,
+                   int &nodesExpanded, int &maxTreeSize, size_t &memoryUse,
+                   double epsilon) {
+    SearchBudget unlimited = {chrono::steady_clock::time_point(), 0,
+                              nullptr};
+    double distance = -1;
+    searchWithBudget(p, unlimited, epsilon, solution, distance, nodesExpanded,
+                     maxTreeSize, memoryUse);
+    return distance;
+}
+
+// REQUIRES: p is a valid Problem, solution is empty
+// MODIFIES: solution, distance
+// EFFECTS : Same as AStarSearch, but checks budget inside the search loop
+//           (the cancel flag and expansion count every expansion, the clock
+//           every few expansions) and stops when any limit is reached.
+//           Returns SEARCH_FOUND with the solution path, SEARCH_EXHAUSTED
+//           with an empty solution, or SEARCH_BUDGET_HIT with a best-effort
+//           result: solution becomes the path from START to the open node
+//           closest to the goal by heuristic (stored FINISH to START like a
+//           full solution). distance is set to the path cost of solution, or
+//           -1 if it is empty.
+SearchStatus budgetedAStarSearch(const Problem &p, const SearchBudget &budget,
+                                 std::vector<State> &solution,
+                                 double &distance, int &nodesExpanded,
+                                 int &maxTreeSize, size_t &memoryUse) {
+    return searchWithBudget(p, budget, 1, solution, distance, nodesExpanded,
+                            maxTreeSize, memoryUse);
+}
+
+// Search record of one state in anytimeSearch. node.pathCost holds the best
+// path cost found so far (g) and node.fCost the open list key.
+struct AnytimeRecord {
+    Tree_Node node;
+    double heuristic;
+    // Whether the state is on the open list
+    bool open;
+    // Whether the state was expanded during the current iteration
+    bool closed;
+    // Whether the state's path cost improved after it was expanded in the
+    // current iteration (ARA*'s INCONS list)
+    bool inconsistent;
+};
+
+// Open list entry: (key, record). Entries whose key no longer matches the
+// record are stale and skipped.
+typedef pair<double, AnytimeRecord*> AnytimeEntry;
+
+// EFFECTS : Returns the smallest pathCost + heuristic over the open and
+//           inconsistent records (a lower bound on the optimal solution
+//           cost), or infinity if there are none
+static double anytimeLowerBound(const deque<AnytimeRecord> &records) {
+    double lowest = numeric_limits<double>::infinity();
+    for (deque<AnytimeRecord>::const_iterator it = records.begin();
+         it != records.end(); ++it) {
+        if (it->open || it->inconsistent) {
+            double bound = it->node.pathCost + it->heuristic;
+            if (bound < lowest) {
+                lowest = bound;
+            }
+        }
+    }
+    return lowest;
+}
+
+// REQUIRES: p is a valid Problem, solutions is empty,
+//           initialEpsilon >= 1, epsilonStep > 0, timeBudget > 0
+// MODIFIES: solutions
+// EFFECTS : Anytime Repairing A* (ARA*). Searches with the heuristic inflated
+//           by initialEpsilon to find a first solution quickly, then lowers
+//           the inflation by epsilonStep and repairs the search (keeping all
+//           path costs found so far) to improve it, until the inflation
+//           reaches 1 or timeBudget seconds have elapsed (steady_clock). Each
+//           improved solution is added to solutions with its cost and proven
+//           suboptimality bound, so the last entry is the best. solutions
+//           stays empty if no solution exists (or none was found in time).
+void anytimeSearch(const Problem &p, double initialEpsilon,
+                   double epsilonStep, double timeBudget,
+                   std::vector<AnytimeSolution> &solutions) {
+    TraceScope trace("anytimeSearch");
+    // Check requires clause
+    assert(solutions.empty());
+    assert(initialEpsilon >= 1 && epsilonStep > 0 && timeBudget > 0);
+    
+    const clock_t searchStart = clock();
+    // Elapsed time, not clock(): that is CPU time summed over all threads
+    const chrono::steady_clock::time_point deadline =
+        chrono::steady_clock::now() +
+        chrono::duration_cast<chrono::steady_clock::duration>(
+            chrono::duration<double>(timeBudget));
+    const double infinity = numeric_limits<double>::infinity();
+    
+    // deque keeps records in place as it grows
+    deque<AnytimeRecord> records;
+    unordered_map<State, AnytimeRecord*, StateHash> recordOf;
+    priority_queue<AnytimeEntry, vector<AnytimeEntry>,
+                   greater<AnytimeEntry>> openList;
+    AnytimeRecord *goal = nullptr;
+    
+    // The root node supplies the start state (and a node for goalTest)
+    Tree_Node *root = p.getRootNode();
+    records.push_back(AnytimeRecord{*root, p.heuristic(root->state), true,
+                                    false, false});
+    delete root;
+    AnytimeRecord *start = &records.back();
+    recordOf[start->node.state] = start;
+    if (p.goalTest(&start->node)) {
+        goal = start;
+    }
+    
+    double epsilon = initialEpsilon;
+    start->node.fCost = epsilon * start->heuristic;
+    openList.push(AnytimeEntry(start->node.fCost, start));
+    
+    double bestCost = infinity;
+    int nodesExpanded = 0;
+    vector<State> possibleStates;
+    vector<double> pathCosts;
+    
+    while (true) {
+        // ImprovePath: expand until no open state could lead to a cheaper
+        // goal under the current inflation
+        bool outOfTime = false;
+        while (!openList.empty()) {
+            AnytimeEntry top = openList.top();
+            AnytimeRecord *current = top.second;
+            if (!current->open || top.first != current->node.fCost) {
+                openList.pop();
+                continue;
+            }
+            if (goal != nullptr && goal->node.pathCost <= top.first) {
+                break;
+            }
+            if (chrono::steady_clock::now() > deadline) {
+                outOfTime = true;
+                break;
+            }
+            openList.pop();
+            current->open = false;
+            current->closed = true;
+            ++nodesExpanded;
+            
+            possibleStates.clear();
+            pathCosts.clear();
+            p.expandOptions(possibleStates, pathCosts, current->node.state);
+            for (int i = 0; i < (int) possibleStates.size(); ++i) {
+                AnytimeRecord *&child = recordOf[possibleStates[i]];
+                if (child == nullptr) {
+                    List<Tree_Node> noChildren(false);
+                    records.push_back(AnytimeRecord{
+                        Tree_Node{possibleStates[i], nullptr, noChildren, 0,
+                                  infinity, infinity},
+                        p.heuristic(possibleStates[i]), false, false, false});
+                    child = &records.back();
+                    if (p.goalTest(&child->node)) {
+                        goal = child;
+                    }
+                }
+                
+                double newPathCost = current->node.pathCost + pathCosts[i];
+                if (newPathCost >= child->node.pathCost) {
+                    continue;
+                }
+                child->node.pathCost = newPathCost;
+                child->node.parent = &current->node;
+                child->node.depth = current->node.depth + 1;
+                if (!child->closed) {
+                    child->node.fCost = newPathCost +
+                                        epsilon * child->heuristic;
+                    child->open = true;
+                    openList.push(AnytimeEntry(child->node.fCost, child));
+                } else {
+                    child->inconsistent = true;
+                }
+            }
+        }
+        
+        if (outOfTime || goal == nullptr || goal->node.pathCost == infinity) {
+            // Out of time, or no solution exists
+            return;
+        }
+        
+        // Publish the solution if it improved
+        if (goal->node.pathCost < bestCost) {
+            bestCost = goal->node.pathCost;
+            AnytimeSolution found;
+            for (const Tree_Node *n = &goal->node; n != nullptr;
+                 n = n->parent) {
+                found.solution.push_back(n->state);
+            }
+            found.cost = bestCost;
+            double lowerBound = anytimeLowerBound(records);
+            found.bound = epsilon;
+            if (lowerBound == infinity) {
+                // Nothing left to search, the solution is optimal
+                found.bound = 1;
+            } else if (bestCost / lowerBound < found.bound) {
+                found.bound = max(1.0, bestCost / lowerBound);
+            }
+            found.time = clock() - searchStart;
+            found.nodesExpanded = nodesExpanded;
+            solutions.push_back(found);
+        }
+        
+        if (epsilon <= 1) {
+            // Solution is optimal
+            return;
+        }
+        epsilon = max(1.0, epsilon - epsilonStep);
+        
+        // Move the inconsistent states to the open list, forget which states
+        // were expanded, and rebuild the open list with the new inflation
+        openList = priority_queue<AnytimeEntry, vector<AnytimeEntry>,
+                                  greater<AnytimeEntry>>();
+        for (deque<AnytimeRecord>::iterator it = records.begin();
+             it != records.end(); ++it) {
+            if (it->inconsistent) {
+                it->open = true;
+                it->inconsistent = false;
+            }
+            it->closed = false;
+            if (it->open) {
+                it->node.fCost = it->node.pathCost + epsilon * it->heuristic;
+                openList.push(AnytimeEntry(it->node.fCost, &*it));
+            }
+        }
+    }
 }
 
 // MODIFIES: searchTree, openList, expandedNode
 // EFFECTS : Adds all valid expanisions of expandedNode to the tree and the open
 //           list. Will not add nodes with states that are in the closedList. If
 //           expandedNode cannot be expanded, deletes expandedNode in tree.
-//           Updates maxTreeSize if approporiate.
+//           Updates maxTreeSize if approporiate. New nodes get an fCost of
+//           pathCost + epsilon * heuristic.
 void expand(const Problem &p, Tree &searchTree,
             const std::vector<State> &closedList, List<Tree_Node> &openList,
-            Tree_Node* expandedNode, int &maxTreeSize) {
+            Tree_Node* expandedNode, int &maxTreeSize, double epsilon) {
     
     // Switch set to true if child found and added
     bool nodeExpanded = false;
@@ -195,7 +490,8 @@ void expand(const Problem &p, Tree &searchTree,
             // Create new node, add to tree and open list
             List<Tree_Node> newNodeChildren(false);
             double newPathCost = expandedNode->pathCost + pathCosts.at(i);
-            double newFCost = newPathCost + p.heuristic(possibleStates.at(i));
+            double newFCost = newPathCost +
+                              epsilon * p.heuristic(possibleStates.at(i));
             // Shallow copy of an empty list should be ok
             // newNode will be owned by mainTree
             Tree_Node *newNode = new Tree_Node{possibleStates.at(i),
@@ -11,8 +11,47 @@
 
 #include "Tree.h"
 #include "AStarProblem.h"
+#include <ctime>
+#include <chrono>
+#include <atomic>
 #include <sys/resource.h>
 
+// How a budgeted search ended
+enum SearchStatus {
+    // A solution was found
+    SEARCH_FOUND,
+    // The open list emptied, so no solution exists
+    SEARCH_EXHAUSTED,
+    // The deadline or expansion budget was reached, or the search was
+    // cancelled, before the search finished
+    SEARCH_BUDGET_HIT
+};
+
+// Limits for budgetedAStarSearch. A zero (or null, or default constructed)
+// member means no limit.
+struct SearchBudget {
+    // Stop once steady_clock::now() passes this time
+    std::chrono::steady_clock::time_point deadline;
+    // Stop after expanding this many nodes
+    int maxExpansions;
+    // Stop once this is set to true (may be set from another thread)
+    const std::atomic<bool> *cancel;
+};
+
+// One solution found by anytimeSearch
+struct AnytimeSolution {
+    // Path from FINISH to START (same order as AStarSearch)
+    std::vector<State> solution;
+    // Path cost of solution
+    double cost;
+    // Proven suboptimality bound: cost <= bound * (optimal cost)
+    double bound;
+    // Clock ticks since anytimeSearch was called
+    clock_t time;
+    // Total nodes expanded since anytimeSearch was called
+    int nodesExpanded;
+};
+
 // REQUIRES: p is a valid Problem, solution is empty
 // MODIFIES: solution
 // EFFECTS : Performs an A-star search on the provided problem.
@@ -26,14 +65,58 @@
 double AStarSearch(const Problem &p, std::vector<State> &solution,
                    int &nodesExpanded, int &maxTreeSize, size_t &memoryUse);
 
+// REQUIRES: p is a valid Problem, solution is empty, epsilon >= 1
+// MODIFIES: solution
+// EFFECTS : Same as above, but orders the open list by
+//           pathCost + epsilon * heuristic (weighted A*), which usually
+//           expands fewer nodes for a longer path. A state keeps the first
+//           path found to it, even if a cheaper one turns up while it is
+//           open, so no bound on the solution cost is guaranteed (use
+//           anytimeSearch for one). epsilon = 1 is a regular A* search.
+double AStarSearch(const Problem &p, std::vector<State> &solution,
+                   int &nodesExpanded, int &maxTreeSize, size_t &memoryUse,
+                   double epsilon);
+
+// REQUIRES: p is a valid Problem, solution is empty
+// MODIFIES: solution, distance
+// EFFECTS : Same as AStarSearch, but checks budget inside the search loop
+//           (the cancel flag and expansion count every expansion, the clock
+//           every few expansions) and stops when any limit is reached.
+//           Returns SEARCH_FOUND with the solution path, SEARCH_EXHAUSTED
+//           with an empty solution, or SEARCH_BUDGET_HIT with a best-effort
+//           result: solution becomes the path from START to the open node
+//           closest to the goal by heuristic (stored FINISH to START like a
+//           full solution). distance is set to the path cost of solution, or
+//           -1 if it is empty.
+SearchStatus budgetedAStarSearch(const Problem &p, const SearchBudget &budget,
+                                 std::vector<State> &solution,
+                                 double &distance, int &nodesExpanded,
+                                 int &maxTreeSize, size_t &memoryUse);
+
+// REQUIRES: p is a valid Problem, solutions is empty,
+//           initialEpsilon >= 1, epsilonStep > 0, timeBudget > 0
+// MODIFIES: solutions
+// EFFECTS : Anytime Repairing A* (ARA*). Searches with the heuristic inflated
+//           by initialEpsilon to find a first solution quickly, then lowers
+//           the inflation by epsilonStep and repairs the search (keeping all
+//           path costs found so far) to improve it, until the inflation
+//           reaches 1 or timeBudget seconds have elapsed (steady_clock). Each
+//           improved solution is added to solutions with its cost and proven
+//           suboptimality bound, so the last entry is the best. solutions
+//           stays empty if no solution exists (or none was found in time).
+void anytimeSearch(const Problem &p, double initialEpsilon,
+                   double epsilonStep, double timeBudget,
+                   std::vector<AnytimeSolution> &solutions);
+
 // MODIFIES: searchTree, openList, expandedNode
 // EFFECTS : Adds all valid expanisions of expandedNode to the tree and the open
 //           list. Will not add nodes with states that are in the closedList. If
 //           expandedNode cannot be expanded, deletes expandedNode in tree.
-//           Updates maxTreeSize if approporiate.
+//           Updates maxTreeSize if approporiate. New nodes get an fCost of
+//           pathCost + epsilon * heuristic.
 void expand(const Problem &p, Tree &searchTree,
             const std::vector<State> &closedList, List<Tree_Node> &openList,
-            Tree_Node* expandedNode, int &maxTreeSize);
+            Tree_Node* expandedNode, int &maxTreeSize, double epsilon);
 
 // REQUIRES: goalNode is a valid pointer to a node. searchTree is a valid tree
 //           with a path from goalNode back to root through parent pointers.
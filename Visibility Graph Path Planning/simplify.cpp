@@ -0,0 +1,306 @@
+//
+//  simplify.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include "simplify.h"
+
+using namespace std;
+
+// Two edges closer than this to parallel (by the sine of the angle between
+// them) are not extended to meet
+static const double PARALLEL_LIMIT = 1e-12;
+
+// EFFECTS : Returns the cross product (b - a) x (c - b), positive for a
+//           counterclockwise turn at b
+static double turn(const Vertex &a, const Vertex &b, const Vertex &c) {
+    return (b.coord[0] - a.coord[0]) * (c.coord[1] - b.coord[1]) -
+           (b.coord[1] - a.coord[1]) * (c.coord[0] - b.coord[0]);
+}
+
+// REQUIRES: polygon has at least 3 vertices
+// EFFECTS : Returns true if every turn of polygon is in the same direction
+//           (collinear vertices are allowed)
+static bool isConvex(const vector<Vertex> &polygon) {
+    const int size = (int) polygon.size();
+    bool left = false;
+    bool right = false;
+    for (int i = 0; i < size; ++i) {
+        double t = turn(polygon[i], polygon[(i + 1) % size],
+                        polygon[(i + 2) % size]);
+        left = left || t > 0;
+        right = right || t < 0;
+    }
+    return !(left && right);
+}
+
+// EFFECTS : Returns the distance from point to the segment [b, c]
+static double segmentDistance(const Vertex &b, const Vertex &c,
+                              const Vertex &point) {
+    double gap[2] = {c.coord[0] - b.coord[0], c.coord[1] - b.coord[1]};
+    double gapSquared = gap[0] * gap[0] + gap[1] * gap[1];
+    if (gapSquared == 0) {
+        return distanceFormula(point, b);
+    }
+    // Parameter of the closest point of the segment
+    double t = (gap[0] * (point.coord[0] - b.coord[0]) +
+                gap[1] * (point.coord[1] - b.coord[1])) / gapSquared;
+    t = fmax(0, fmin(1, t));
+    return hypot(point.coord[0] - (b.coord[0] + t * gap[0]),
+                 point.coord[1] - (b.coord[1] + t * gap[1]));
+}
+
+// REQUIRES: polygon has at least 3 vertices, point is not inside it
+// EFFECTS : Returns the distance from point to polygon
+static double polygonDistance(const vector<Vertex> &polygon,
+                              const Vertex &point) {
+    double distance = numeric_limits<double>::infinity();
+    for (size_t i = 0; i < polygon.size(); ++i) {
+        distance = fmin(distance,
+                        segmentDistance(polygon[i],
+                                        polygon[(i + 1) % polygon.size()],
+                                        point));
+    }
+    return distance;
+}
+
+// EFFECTS : Returns true if two consecutive vertices of polygon are the same
+//           point (rounding to a coarse fixed-point grid can do this)
+static bool hasRepeatedVertex(const vector<Vertex> &polygon) {
+    for (size_t i = 0; i < polygon.size(); ++i) {
+        if (polygon[i] == polygon[(i + 1) % polygon.size()]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// REQUIRES: before, a, b, c, d, after are consecutive vertices of a convex
+//           polygon (before may be after), outside is the orientationSign
+//           of a point outside one of its edges
+// EFFECTS : Returns true if replacing b and c with corner keeps the polygon
+//           convex and still enclosing b and c, decided exactly
+static bool keepsPolygon(const Vertex &before, const Vertex &a,
+                         const Vertex &b, const Vertex &c, const Vertex &d,
+                         const Vertex &after, int outside,
+                         const Vertex &corner) {
+    return !(corner == a) && !(corner == d) &&
+           orientationSign(a, corner, b) != outside &&
+           orientationSign(a, corner, c) != outside &&
+           orientationSign(corner, d, b) != outside &&
+           orientationSign(corner, d, c) != outside &&
+           orientationSign(before, a, corner) != outside &&
+           orientationSign(a, corner, d) != outside &&
+           orientationSign(corner, d, after) != outside;
+}
+
+// REQUIRES: before, a, b, c, d, after are consecutive vertices of a convex
+//           polygon (before may be after), outside is the orientationSign
+//           of a point outside one of its edges, original is the polygon
+//           before any edge was removed
+// MODIFIES: corner, deviation
+// EFFECTS : If edge [b, c] can be removed by extending [a, b] past b and
+//           [d, c] past c until they meet, sets corner to where they meet and
+//           deviation to the distance from corner to original, and returns
+//           true. Returns false if the extensions do not meet (they are
+//           parallel or diverge). The meeting point is rounded, so corner is
+//           the point next to it (a grid point in fixed-point mode, see
+//           snapToGrid) closest to original that keepsPolygon accepts;
+//           returns false if there is none.
+static bool collapseEdge(const Vertex &before, const Vertex &a,
+                         const Vertex &b, const Vertex &c, const Vertex &d,
+                         const Vertex &after, int outside,
+                         const vector<Vertex> &original, Vertex &corner,
+                         double &deviation) {
+    // Solve b + t * (b - a) == c + s * (c - d) with t, s >= 0
+    double u[2] = {b.coord[0] - a.coord[0], b.coord[1] - a.coord[1]};
+    double w[2] = {d.coord[0] - c.coord[0], d.coord[1] - c.coord[1]};
+    double gap[2] = {c.coord[0] - b.coord[0], c.coord[1] - b.coord[1]};
+    double denominator = u[0] * w[1] - u[1] * w[0];
+    double uLength = hypot(u[0], u[1]);
+    double wLength = hypot(w[0], w[1]);
+    if (fabs(denominator) <= PARALLEL_LIMIT * uLength * wLength) {
+        return false;
+    }
+    double t = (gap[0] * w[1] - gap[1] * w[0]) / denominator;
+    double s = (u[0] * gap[1] - u[1] * gap[0]) / denominator;
+    if (t < 0 || s < 0) {
+        return false;
+    }
+    double meet[2] = {b.coord[0] + t * u[0], b.coord[1] + t * u[1]};
+
+    // Candidates: the rounded meeting point and the doubles next to it, or
+    // in fixed-point mode the four grid points around it (the nearest one
+    // may be inside)
+    const double resolution = fixedPointResolution();
+    Vertex candidates[9];
+    int numCandidates = 0;
+    if (resolution == 0) {
+        for (int i = 0; i < 9; ++i) {
+            const double toward[3] = {-HUGE_VAL, 0, HUGE_VAL};
+            candidates[numCandidates] = b;
+            for (int j = 0; j < 2; ++j) {
+                double step = toward[j == 0 ? i % 3 : i / 3];
+                candidates[numCandidates].coord[j] =
+                    step == 0 ? meet[j] : nextafter(meet[j], step);
+            }
+            ++numCandidates;
+        }
+    } else {
+        for (int i = 0; i < 4; ++i) {
+            candidates[numCandidates] = b;
+            candidates[numCandidates].coord[0] =
+                (i & 1 ? ceil(meet[0] / resolution)
+                       : floor(meet[0] / resolution)) * resolution;
+            candidates[numCandidates].coord[1] =
+                (i & 2 ? ceil(meet[1] / resolution)
+                       : floor(meet[1] / resolution)) * resolution;
+            snapToGrid(candidates[numCandidates]);
+            ++numCandidates;
+        }
+    }
+
+    deviation = numeric_limits<double>::infinity();
+    for (int i = 0; i < numCandidates; ++i) {
+        if (!keepsPolygon(before, a, b, c, d, after, outside,
+                          candidates[i])) {
+            continue;
+        }
+        double candidateDeviation = polygonDistance(original,
+                                                    candidates[i]);
+        if (candidateDeviation < deviation) {
+            corner = candidates[i];
+            deviation = candidateDeviation;
+        }
+    }
+    return deviation < numeric_limits<double>::infinity();
+}
+
+// REQUIRES: polygon is convex with at least 3 vertices, tolerance >= 0
+// MODIFIES: polygon, loopCounter
+// EFFECTS : Simplifies polygon as described for simplifyPolygons
+static void simplifyPolygon(vector<Vertex> &polygon, double tolerance,
+                            int &loopCounter) {
+    // Deviations are measured from the original, so they do not add up
+    // over collapses. Both polygons are convex and the simplified one
+    // encloses the original, so the farthest point from the original is
+    // one of the new corners.
+    const vector<Vertex> original = polygon;
+
+    // Twice the signed area: positive if polygon runs counterclockwise
+    double area = 0;
+    for (size_t i = 0; i < polygon.size(); ++i) {
+        const Vertex &next = polygon[(i + 1) % polygon.size()];
+        area += polygon[i].coord[0] * next.coord[1] -
+                next.coord[0] * polygon[i].coord[1];
+    }
+    // orientationSign is 1 for a clockwise turn, which leaves a
+    // counterclockwise polygon
+    const int outside = area > 0 ? 1 : -1;
+
+    while (polygon.size() > 3) {
+        const int size = (int) polygon.size();
+        int bestEdge = -1;
+        double bestDeviation = numeric_limits<double>::infinity();
+        Vertex bestCorner = polygon[0];
+        for (int i = 0; i < size; ++i) {
+            ++loopCounter;
+            Vertex corner = polygon[i];
+            double deviation;
+            if (collapseEdge(polygon[(i + size - 2) % size],
+                             polygon[(i + size - 1) % size], polygon[i],
+                             polygon[(i + 1) % size],
+                             polygon[(i + 2) % size],
+                             polygon[(i + 3) % size], outside, original,
+                             corner, deviation) &&
+                deviation < bestDeviation) {
+                bestEdge = i;
+                bestDeviation = deviation;
+                bestCorner = corner;
+            }
+        }
+        if (bestEdge == -1 || bestDeviation > tolerance) {
+            return;
+        }
+
+        // The corner replaces both endpoints of the edge
+        polygon[bestEdge] = bestCorner;
+        polygon.erase(polygon.begin() + (bestEdge + 1) % size);
+    }
+}
+
+// REQUIRES: tolerance >= 0, polygons contains valid polygon objects, no two
+//           polygons are closer than tolerance (otherwise the grown polygons
+//           may overlap)
+// MODIFIES: polygons, loopCounter
+// EFFECTS : Simplifies every convex polygon in polygons: repeatedly removes
+//           the edge whose removal moves the boundary the least (replacing
+//           its two endpoints with the point where the neighboring edges
+//           meet), as long as that point is within tolerance of the
+//           original polygon and the polygon keeps at least 3 vertices. Each
+//           simplified polygon encloses its original and is within tolerance
+//           of it: a new corner is placed (on the grid in fixed-point mode)
+//           only where exact orientation tests show the polygon stays convex
+//           and still encloses the removed vertices. Non-convex polygons and
+//           polygons with repeated vertices are left alone. Vertex locations
+//           and polygon sizes are renumbered; polygon indices are unchanged.
+//           Returns the number of vertices removed. Adds the number of
+//           candidate edges examined to loopCounter.
+int simplifyPolygons(List<List<Vertex>> &polygons, double tolerance,
+                     int &loopCounter) {
+    // Edges are extended in the plane
+    static_assert(DIMENSIONS == 2, "polygons are simplified in the plane");
+    assert(tolerance >= 0);
+
+    int removed = 0;
+    List<List<Vertex>>::Iterator endP = polygons.end();
+    for (List<List<Vertex>>::Iterator pgon = polygons.begin(); pgon != endP;
+         ++pgon) {
+        vector<Vertex> polygon;
+        List<Vertex>::Iterator endV = (*pgon)->end();
+        for (List<Vertex>::Iterator v = (*pgon)->begin(); v != endV; ++v) {
+            polygon.push_back(**v);
+        }
+        if (polygon.size() <= 3 || !isConvex(polygon) ||
+            hasRepeatedVertex(polygon)) {
+            continue;
+        }
+
+        simplifyPolygon(polygon, tolerance, loopCounter);
+        if (polygon.size() == (size_t) (*pgon)->size()) {
+            continue;
+        }
+        removed += (*pgon)->size() - (int) polygon.size();
+
+        // Replace the vertices (the polygon list owns them)
+        (*pgon)->removeIf([](Vertex *) { return true; });
+        for (int i = 0; i < (int) polygon.size(); ++i) {
+            Vertex *v = new Vertex(polygon[i]);
+            v->location = i;
+            v->poly_size = (int) polygon.size();
+            (*pgon)->insertEnd(v);
+        }
+    }
+    return removed;
+}
+
+// REQUIRES: polygon contains a valid convex polygon
+// EFFECTS : Returns true if point is strictly inside polygon
+bool insideConvexPolygon(const List<Vertex> &polygon, const Vertex &point) {
+    bool left = false;
+    bool right = false;
+    List<Vertex>::Iterator v1 = polygon.begin();
+    for (int i = 0; i < polygon.size(); ++i) {
+        List<Vertex>::Iterator v2 = v1;
+        v2.circularIncrement(polygon.begin());
+        double t = turn(**v1, **v2, point);
+        left = left || t >= 0;
+        right = right || t <= 0;
+        v1 = v2;
+    }
+    return !(left && right);
+}
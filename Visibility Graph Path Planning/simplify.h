@@ -0,0 +1,42 @@
+//
+//  simplify.h
+//  Visibility Graph Path Planning
+//
+//  Level-of-detail pass for convex obstacles. Visibility graph construction
+//  is cubic in the number of polygon vertices, and many generated obstacles
+//  have far more vertices than their size warrants. An edge of a convex
+//  polygon can be removed by extending its two neighboring edges until they
+//  meet; the polygon stays convex and only grows, so a path that avoids the
+//  simplified polygon also avoids the original.
+//
+
+#ifndef simplify_h
+#define simplify_h
+
+#include "preprocessing.h"
+
+// REQUIRES: tolerance >= 0, polygons contains valid polygon objects, no two
+//           polygons are closer than tolerance (otherwise the grown polygons
+//           may overlap)
+// MODIFIES: polygons, loopCounter
+// EFFECTS : Simplifies every convex polygon in polygons: repeatedly removes
+//           the edge whose removal moves the boundary the least (replacing
+//           its two endpoints with the point where the neighboring edges
+//           meet), as long as that point is within tolerance of the
+//           original polygon and the polygon keeps at least 3 vertices. Each
+//           simplified polygon encloses its original and is within tolerance
+//           of it: a new corner is placed (on the grid in fixed-point mode)
+//           only where exact orientation tests show the polygon stays convex
+//           and still encloses the removed vertices. Non-convex polygons and
+//           polygons with repeated vertices are left alone. Vertex locations
+//           and polygon sizes are renumbered; polygon indices are unchanged.
+//           Returns the number of vertices removed. Adds the number of
+//           candidate edges examined to loopCounter.
+int simplifyPolygons(List<List<Vertex>> &polygons, double tolerance,
+                     int &loopCounter);
+
+// REQUIRES: polygon contains a valid convex polygon
+// EFFECTS : Returns true if point is strictly inside polygon
+bool insideConvexPolygon(const List<Vertex> &polygon, const Vertex &point);
+
+#endif /* simplify_h */
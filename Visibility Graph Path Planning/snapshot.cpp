@@ -0,0 +1,107 @@
+//
+//  snapshot.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include "snapshot.h"
+#include "AStarProblem.h"
+#include "search_functions.h"
+
+using namespace std;
+
+// Constructs an empty snapshot that owns its graph and polygons
+GraphSnapshot::GraphSnapshot() :
+polygons(true), version(0) {}
+
+// REQUIRES: polygonFile is as preProcess requires
+// MODIFIES: polygonFile
+// EFFECTS : Runs preProcess on polygonFile and returns the result as a
+//           read-only snapshot with the given version
+std::shared_ptr<const GraphSnapshot> buildSnapshot(std::istream &polygonFile,
+                                                   int version) {
+    shared_ptr<GraphSnapshot> snapshot = make_shared<GraphSnapshot>();
+    
+    // Need dummy counters (see testing code for actual use)
+    int dummyCounter = 0;
+    preProcess(snapshot->graph, polygonFile, snapshot->polygons, dummyCounter,
+               dummyCounter, dummyCounter, dummyCounter, dummyCounter);
+    snapshot->version = version;
+    
+    return snapshot;
+}
+
+// REQUIRES: start and goal are not in the interior of a polygon of snapshot,
+//           solution is empty
+// MODIFIES: solution, nodesExpanded
+// EFFECTS : Searches snapshot without changing it: attaches start and goal to
+//           a shallow copy of its graph and runs AStarSearch (or connects them
+//           directly if they see each other). solution is in the order
+//           AStarSearch uses and points at start, goal and vertices of
+//           snapshot, so snapshot must stay pinned while it is used. Returns
+//           the path cost, or -1 on failure.
+double snapshotSearch(const GraphSnapshot &snapshot, Vertex *start,
+                      Vertex *goal, std::vector<State> &solution,
+                      int &nodesExpanded) {
+    assert(solution.empty());
+    
+    State startState = {start};
+    State goalState = {goal};
+    
+    int dummyCounter = 0;
+    if (visible(*start, *goal, snapshot.polygons, dummyCounter)) {
+        solution.push_back(goalState);
+        solution.push_back(startState);
+        return distanceFormula(*start, *goal);
+    }
+    
+    // Copy-construct a new graph (won't own data, so the snapshot's vertices
+    // and edges are only read). victims owns the edges added for start and
+    // goal.
+    Graph searchGraph(snapshot.graph);
+    List<Edge> victims(true);
+    
+    searchGraph.vertices.insertStart(goal);
+    searchGraph.vertices.insertStart(start);
+    List<Vertex>::Iterator it_start = searchGraph.vertices.begin();
+    List<Vertex>::Iterator it_goal = it_start;
+    ++it_goal;
+    visibleVertices(it_start, searchGraph, snapshot.polygons, dummyCounter,
+                    dummyCounter, victims);
+    visibleVertices(it_goal, searchGraph, snapshot.polygons, dummyCounter,
+                    dummyCounter, victims);
+    
+    Problem prob(searchGraph, startState, goalState);
+    int maxTreeSize = 0;
+    size_t memoryUse = 0;
+    return AStarSearch(prob, solution, nodesExpanded, maxTreeSize, memoryUse);
+}
+
+// REQUIRES: initial is not null
+// EFFECTS : Makes initial the current snapshot
+SnapshotRegistry::SnapshotRegistry(
+    std::shared_ptr<const GraphSnapshot> initial) :
+current(initial) {
+    assert(initial);
+}
+
+// EFFECTS : Returns the current snapshot. The snapshot stays alive while
+//           the returned pointer (or a copy of it) exists, even after a
+//           newer one is published.
+std::shared_ptr<const GraphSnapshot> SnapshotRegistry::pin() const {
+    return atomic_load(&current);
+}
+
+// REQUIRES: next is not null
+// MODIFIES: this
+// EFFECTS : Atomically makes next the current snapshot. The previous one
+//           is deleted once no reader has it pinned.
+void SnapshotRegistry::publish(std::shared_ptr<const GraphSnapshot> next) {
+    assert(next);
+    atomic_store(&current, next);
+}
+
+// EFFECTS : Returns the version of the current snapshot
+int SnapshotRegistry::version() const {
+    return pin()->version;
+}
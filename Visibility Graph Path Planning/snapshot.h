@@ -0,0 +1,83 @@
+//
+//  snapshot.h
+//  Visibility Graph Path Planning
+//
+//  Read-only, versioned visibility graphs for many concurrent query threads.
+//  A snapshot is never changed after it is built, so searches need no locks.
+//  A registry holds the current snapshot: readers pin it by copying a
+//  shared_ptr, and a rebuild publishes a replacement with an atomic store.
+//  Readers that pinned the old snapshot keep using it, and it is deleted
+//  when the last of them lets go.
+//
+
+#ifndef snapshot_h
+#define snapshot_h
+
+#include <vector>
+#include <memory>
+#include <iostream>
+#include "preprocessing.h"
+#include "AStarState.h"
+
+struct GraphSnapshot {
+    // Visibility graph of the polygon vertices (without start and goal)
+    Graph graph;
+    // Polygons graph was built from, for attaching start and goal
+    List<List<Vertex>> polygons;
+    // Version number given by the builder
+    int version;
+    
+    // Constructs an empty snapshot that owns its graph and polygons
+    GraphSnapshot();
+    
+    // Snapshots are shared, never copied
+    GraphSnapshot(const GraphSnapshot &other) = delete;
+    GraphSnapshot & operator=(const GraphSnapshot &rhs) = delete;
+};
+
+// REQUIRES: polygonFile is as preProcess requires
+// MODIFIES: polygonFile
+// EFFECTS : Runs preProcess on polygonFile and returns the result as a
+//           read-only snapshot with the given version
+std::shared_ptr<const GraphSnapshot> buildSnapshot(std::istream &polygonFile,
+                                                   int version);
+
+// REQUIRES: start and goal are not in the interior of a polygon of snapshot,
+//           solution is empty
+// MODIFIES: solution, nodesExpanded
+// EFFECTS : Searches snapshot without changing it: attaches start and goal to
+//           a shallow copy of its graph and runs AStarSearch (or connects them
+//           directly if they see each other). solution is in the order
+//           AStarSearch uses and points at start, goal and vertices of
+//           snapshot, so snapshot must stay pinned while it is used. Returns
+//           the path cost, or -1 on failure.
+double snapshotSearch(const GraphSnapshot &snapshot, Vertex *start,
+                      Vertex *goal, std::vector<State> &solution,
+                      int &nodesExpanded);
+
+class SnapshotRegistry {
+private:
+    // Only accessed through std::atomic_load and std::atomic_store
+    std::shared_ptr<const GraphSnapshot> current;
+    
+public:
+    // REQUIRES: initial is not null
+    // EFFECTS : Makes initial the current snapshot
+    explicit SnapshotRegistry(std::shared_ptr<const GraphSnapshot> initial);
+    
+    // EFFECTS : Returns the current snapshot. The snapshot stays alive while
+    //           the returned pointer (or a copy of it) exists, even after a
+    //           newer one is published.
+    std::shared_ptr<const GraphSnapshot> pin() const;
+    
+    // REQUIRES: next is not null
+    // MODIFIES: this
+    // EFFECTS : Atomically makes next the current snapshot. The previous one
+    //           is deleted once no reader has it pinned.
+    void publish(std::shared_ptr<const GraphSnapshot> next);
+    
+    // EFFECTS : Returns the version of the current snapshot
+    int version() const;
+};
+
+#endif /* snapshot_h */
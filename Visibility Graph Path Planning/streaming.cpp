@@ -0,0 +1,538 @@
+//
+//  streaming.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <limits>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <type_traits>
+#include "streaming.h"
+
+#if defined(__unix__) || defined(__unix) || defined(unix) || (defined(__APPLE__) && defined(__MACH__))
+#define STREAMING_USE_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+// Vertices are written to and mapped from the file byte for byte
+static_assert(is_standard_layout<Vertex>::value,
+              "Vertex must be standard layout to be stored in a file");
+
+static const char ADJACENCY_MAGIC[8] = "VGRAPH1";
+
+// Edge entry waiting in the buffer or in a run file
+struct SpillRecord {
+    int32_t source;
+    int32_t target;
+    double length;
+};
+
+// EFFECTS : Orders records by source, then target
+static bool operator<(const SpillRecord &lhs, const SpillRecord &rhs) {
+    return lhs.source < rhs.source ||
+           (lhs.source == rhs.source && lhs.target < rhs.target);
+}
+
+// MODIFIES: buffer, runPaths
+// EFFECTS : Sorts buffer and writes it to a new run file next to path, then
+//           empties it. Returns false if the run could not be written.
+static bool spillRun(vector<SpillRecord> &buffer, const string &path,
+                     vector<string> &runPaths) {
+    sort(buffer.begin(), buffer.end());
+    
+    string runPath = path + ".run" + to_string(runPaths.size());
+    ofstream run(runPath, ios::binary);
+    if (!run) {
+        return false;
+    }
+    run.write(reinterpret_cast<const char*>(buffer.data()),
+              buffer.size() * sizeof(SpillRecord));
+    runPaths.push_back(runPath);
+    buffer.clear();
+    return (bool) run;
+}
+
+// Most run files a merge reads at once, so a small budget with many runs
+// does not run out of file descriptors
+static const size_t MAX_MERGE_FAN_IN = 64;
+// Records per run block a merge aims for before it lowers its fan-in
+static const size_t MIN_MERGE_BLOCK = 256;
+
+// Reads a run file one block of records at a time. The stream itself is
+// unbuffered, so the block is all the memory a run takes during a merge.
+class RunReader {
+private:
+    ifstream in;
+    vector<SpillRecord> block;
+    size_t next;
+    bool failed;
+    
+public:
+    // EFFECTS : Opens the run at path, to be read blockRecords records at a
+    //           time. Check failed() for whether it opened.
+    RunReader(const string &path, size_t blockRecords)
+    : next(0), failed(false) {
+        block.reserve(blockRecords);
+        in.rdbuf()->pubsetbuf(nullptr, 0);
+        in.open(path, ios::binary);
+        failed = !in;
+    }
+    
+    // MODIFIES: this
+    // EFFECTS : Sets record to the next record and returns true, or returns
+    //           false at the end of the run or if it could not be read
+    bool read(SpillRecord &record) {
+        if (next == block.size()) {
+            if (failed || in.eof()) {
+                return false;
+            }
+            block.resize(block.capacity());
+            in.read(reinterpret_cast<char*>(block.data()),
+                    block.size() * sizeof(SpillRecord));
+            streamsize bytes = in.gcount();
+            // A partial record, or an error other than reaching the end
+            if (bytes % sizeof(SpillRecord) != 0 || (!in && !in.eof())) {
+                failed = true;
+                return false;
+            }
+            block.resize(bytes / sizeof(SpillRecord));
+            next = 0;
+            if (block.empty()) {
+                return false;
+            }
+        }
+        record = block[next++];
+        return true;
+    }
+    
+    // EFFECTS : Returns true if the run could not be opened or read
+    bool failedToRead() const {
+        return failed;
+    }
+};
+
+// REQUIRES: every run in runPaths is sorted, emit takes a SpillRecord and
+//           returns false if it could not write it
+// MODIFIES: emit's output
+// EFFECTS : Merges the runs in runPaths (at most MAX_MERGE_FAN_IN of them),
+//           reading blockRecords records of each at a time, and passes the
+//           records to emit in order. Returns false if a run could not be
+//           opened or read, or if emit failed.
+template <typename Emit>
+static bool mergeRuns(const vector<string> &runPaths, size_t blockRecords,
+                      Emit emit) {
+    vector<unique_ptr<RunReader>> runs;
+    typedef pair<SpillRecord, int> MergeEntry;
+    priority_queue<MergeEntry, vector<MergeEntry>, greater<MergeEntry>> heads;
+    for (int r = 0; r < (int) runPaths.size(); ++r) {
+        runs.push_back(unique_ptr<RunReader>(new RunReader(runPaths[r],
+                                                           blockRecords)));
+        SpillRecord record;
+        if (runs[r]->read(record)) {
+            heads.push(MergeEntry(record, r));
+        } else if (runs[r]->failedToRead()) {
+            return false;
+        }
+    }
+    while (!heads.empty()) {
+        MergeEntry head = heads.top();
+        heads.pop();
+        if (!emit(head.first)) {
+            return false;
+        }
+        SpillRecord record;
+        if (runs[head.second]->read(record)) {
+            heads.push(MergeEntry(record, head.second));
+        } else if (runs[head.second]->failedToRead()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// MODIFIES: the files in runPaths
+// EFFECTS : Deletes the run files in runPaths
+static void removeRuns(const vector<string> &runPaths) {
+    for (int r = 0; r < (int) runPaths.size(); ++r) {
+        remove(runPaths[r].c_str());
+    }
+}
+
+// REQUIRES: polygons contains valid polygon obstacles, memoryBudget is at
+//           least sizeof(MappedEdge) * 2
+// MODIFIES: stats, visibleCounter, the file at path (and temporary run files
+//           next to it)
+// EFFECTS : Writes the visibility graph of polygons (the same edges
+//           preProcess builds) to an adjacency file at path, holding at most
+//           memoryBudget bytes of edges in memory at a time. The sorted runs
+//           are merged in passes of at most 64 runs, fewer if the budget
+//           cannot give each run a block of 256 edges, and the runs being
+//           merged share the budget. Adds the number of loops run by visible
+//           to visibleCounter. Returns false if a file could not be written
+//           or read back, or if the merge did not return every edge.
+bool streamingBuild(List<List<Vertex>> const &polygons,
+                    const std::string &path, size_t memoryBudget,
+                    StreamingStats &stats, int &visibleCounter) {
+    // Each edge is buffered once per endpoint
+    const size_t capacity = memoryBudget / sizeof(SpillRecord);
+    assert(capacity >= 2);
+    
+    stats = StreamingStats{0, 0, 0};
+    
+    // Number the vertices in the order addVertices would
+    vector<const Vertex*> vertices;
+    List<List<Vertex>>::Iterator endP = polygons.end();
+    for (List<List<Vertex>>::Iterator pgon = polygons.begin(); pgon != endP;
+         ++pgon) {
+        List<Vertex>::Iterator endV = (*pgon)->end();
+        for (List<Vertex>::Iterator v = (*pgon)->begin(); v != endV; ++v) {
+            vertices.push_back(*v);
+        }
+    }
+    const int numVertices = (int) vertices.size();
+    PolygonCones cones;
+    findPolygonCones(polygons, cones);
+    
+    // Collect the edges source by source, spilling whenever the buffer fills
+    vector<SpillRecord> buffer;
+    buffer.reserve(capacity);
+    vector<string> runPaths;
+    for (int i = 0; i < numVertices; ++i) {
+        for (int j = i + 1; j < numVertices; ++j) {
+            if (!visible(*vertices[i], *vertices[j], polygons,
+                         visibleCounter, &cones)) {
+                continue;
+            }
+            if (buffer.size() + 2 > capacity &&
+                !spillRun(buffer, path, runPaths)) {
+                removeRuns(runPaths);
+                return false;
+            }
+            double distance = distanceFormula(*vertices[i], *vertices[j]);
+            buffer.push_back(SpillRecord{i, j, distance});
+            buffer.push_back(SpillRecord{j, i, distance});
+            stats.numEdges += 2;
+            stats.peakBufferBytes = max(stats.peakBufferBytes,
+                                        buffer.size() * sizeof(SpillRecord));
+        }
+    }
+    if (!buffer.empty() && !spillRun(buffer, path, runPaths)) {
+        removeRuns(runPaths);
+        return false;
+    }
+    stats.numRuns = (int) runPaths.size();
+    
+    ofstream out(path, ios::binary);
+    if (!out) {
+        removeRuns(runPaths);
+        return false;
+    }
+    MappedHeader header;
+    memcpy(header.magic, ADJACENCY_MAGIC, sizeof(header.magic));
+    header.numVertices = numVertices;
+    header.numEdges = stats.numEdges;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int i = 0; i < numVertices; ++i) {
+        out.write(reinterpret_cast<const char*>(vertices[i]), sizeof(Vertex));
+    }
+    
+    // Offsets are only known after the merge, leave room for them
+    const streampos offsetsStart = out.tellp();
+    vector<uint64_t> offsets(numVertices + 1, 0);
+    out.write(reinterpret_cast<const char*>(offsets.data()),
+              offsets.size() * sizeof(uint64_t));
+    
+    // The runs' blocks share the budget, so a small budget merges fewer runs
+    // at a time (in more passes) rather than holding more in memory
+    const size_t fanIn = max((size_t) 2,
+                             min(MAX_MERGE_FAN_IN,
+                                 capacity / MIN_MERGE_BLOCK));
+    const size_t blockRecords = max((size_t) 1, capacity / fanIn);
+    
+    // Merge groups of runs into longer runs until one pass can finish
+    for (int pass = 0; runPaths.size() > fanIn; ++pass) {
+        vector<string> merged;
+        for (size_t first = 0; first < runPaths.size(); first += fanIn) {
+            vector<string> group(runPaths.begin() + first,
+                                 runPaths.begin() +
+                                 min(first + fanIn, runPaths.size()));
+            string mergedPath = path + ".merge" + to_string(pass) + "_" +
+                                to_string(merged.size());
+            merged.push_back(mergedPath);
+            ofstream mergedRun(mergedPath, ios::binary);
+            bool written = mergedRun &&
+                mergeRuns(group, blockRecords,
+                          [&](const SpillRecord &record) {
+                    mergedRun.write(reinterpret_cast<const char*>(&record),
+                                    sizeof(record));
+                    return (bool) mergedRun;
+                });
+            mergedRun.close();
+            removeRuns(group);
+            if (!written) {
+                removeRuns(merged);
+                removeRuns(vector<string>(runPaths.begin() + first +
+                                          group.size(), runPaths.end()));
+                return false;
+            }
+        }
+        runPaths.swap(merged);
+    }
+    
+    // Final pass straight into the adjacency file
+    int64_t mergedEdges = 0;
+    bool mergedAll = mergeRuns(runPaths, blockRecords,
+                               [&](const SpillRecord &record) {
+        MappedEdge edge = {record.target, 0, record.length};
+        out.write(reinterpret_cast<const char*>(&edge), sizeof(edge));
+        ++offsets[record.source + 1];
+        ++mergedEdges;
+        return (bool) out;
+    });
+    removeRuns(runPaths);
+    // Every edge collected must have made it through the runs
+    if (!mergedAll || mergedEdges != stats.numEdges) {
+        return false;
+    }
+    
+    // Counts to offsets
+    for (int i = 0; i < numVertices; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    out.seekp(offsetsStart);
+    out.write(reinterpret_cast<const char*>(offsets.data()),
+              offsets.size() * sizeof(uint64_t));
+    return (bool) out;
+}
+
+// Constructs a MappedGraph with no file open
+MappedGraph::MappedGraph() :
+data(nullptr), bytes(0), header(nullptr), vertexArray(nullptr),
+offsetArray(nullptr), edgeArray(nullptr) {}
+
+// Unmaps the file
+MappedGraph::~MappedGraph() {
+    close();
+}
+
+// REQUIRES: no file is open
+// MODIFIES: this
+// EFFECTS : Maps the adjacency file at path. Returns false if it could not
+//           be opened or is not an adjacency file.
+bool MappedGraph::open(const std::string &path) {
+    assert(data == nullptr);
+    
+#ifdef STREAMING_USE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t) sizeof(MappedHeader)) {
+        ::close(fd);
+        return false;
+    }
+    bytes = (size_t) info.st_size;
+    void *mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        bytes = 0;
+        return false;
+    }
+    data = mapping;
+#else
+    // No mmap, read the whole file instead
+    ifstream in(path, ios::binary);
+    if (!in) {
+        return false;
+    }
+    fallback.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    if (fallback.size() < sizeof(MappedHeader)) {
+        fallback.clear();
+        return false;
+    }
+    bytes = fallback.size();
+    data = fallback.data();
+#endif
+    
+    const char *base = static_cast<const char*>(data);
+    header = reinterpret_cast<const MappedHeader*>(base);
+    size_t expected = sizeof(MappedHeader) +
+                      header->numVertices * sizeof(Vertex) +
+                      (header->numVertices + 1) * sizeof(uint64_t) +
+                      header->numEdges * sizeof(MappedEdge);
+    if (memcmp(header->magic, ADJACENCY_MAGIC, sizeof(header->magic)) != 0 ||
+        expected != bytes) {
+        close();
+        return false;
+    }
+    
+    vertexArray = reinterpret_cast<const Vertex*>(base + sizeof(MappedHeader));
+    offsetArray = reinterpret_cast<const uint64_t*>(
+        vertexArray + header->numVertices);
+    edgeArray = reinterpret_cast<const MappedEdge*>(
+        offsetArray + header->numVertices + 1);
+    return true;
+}
+
+// MODIFIES: this
+// EFFECTS : Unmaps the file, if one is open
+void MappedGraph::close() {
+#ifdef STREAMING_USE_MMAP
+    if (data != nullptr) {
+        munmap(data, bytes);
+    }
+#else
+    fallback.clear();
+#endif
+    data = nullptr;
+    bytes = 0;
+    header = nullptr;
+    vertexArray = nullptr;
+    offsetArray = nullptr;
+    edgeArray = nullptr;
+}
+
+// REQUIRES: a file is open
+// EFFECTS : Returns the number of vertices
+int MappedGraph::numVertices() const {
+    assert(header != nullptr);
+    return (int) header->numVertices;
+}
+
+// REQUIRES: a file is open, 0 <= v < numVertices()
+// EFFECTS : Returns vertex v (valid until the file is closed)
+const Vertex* MappedGraph::vertex(int v) const {
+    assert(v >= 0 && v < numVertices());
+    return vertexArray + v;
+}
+
+// REQUIRES: a file is open, 0 <= v < numVertices()
+// EFFECTS : Returns the first of v's edges and one past the last
+const MappedEdge* MappedGraph::edgesBegin(int v) const {
+    assert(v >= 0 && v < numVertices());
+    return edgeArray + offsetArray[v];
+}
+const MappedEdge* MappedGraph::edgesEnd(int v) const {
+    assert(v >= 0 && v < numVertices());
+    return edgeArray + offsetArray[v + 1];
+}
+
+// REQUIRES: graph is open and was built from polygons, start and goal are not
+//           in the interior of a polygon, solution is empty
+// MODIFIES: solution, nodesExpanded
+// EFFECTS : Attaches start and goal to the mapped graph (keeping their edges
+//           in memory) and runs A* over it. solution becomes the path from
+//           goal back to start (the order AStarSearch uses), with pointers
+//           into the mapping, or empty on failure. Adds the number of
+//           vertices expanded to nodesExpanded. Returns the path cost, or -1
+//           on failure.
+double mappedSearch(const MappedGraph &graph,
+                    List<List<Vertex>> const &polygons, Vertex *start,
+                    Vertex *goal, std::vector<State> &solution,
+                    int &nodesExpanded) {
+    assert(solution.empty());
+    
+    const double infinity = numeric_limits<double>::infinity();
+    int dummyCounter = 0;
+    
+    if (visible(*start, *goal, polygons, dummyCounter)) {
+        solution.push_back(State{goal});
+        solution.push_back(State{start});
+        return distanceFormula(*start, *goal);
+    }
+    
+    // Start and goal are numbered after the mapped vertices
+    const int numVertices = graph.numVertices();
+    const int startNode = numVertices;
+    const int goalNode = numVertices + 1;
+    vector<double> startSees(numVertices, infinity);
+    vector<double> goalSees(numVertices, infinity);
+    for (int v = 0; v < numVertices; ++v) {
+        const Vertex &check = *graph.vertex(v);
+        if (visible(*start, check, polygons, dummyCounter)) {
+            startSees[v] = distanceFormula(*start, check);
+        }
+        if (visible(*goal, check, polygons, dummyCounter)) {
+            goalSees[v] = distanceFormula(*goal, check);
+        }
+    }
+    
+    vector<double> pathCost(numVertices + 2, infinity);
+    vector<int> parent(numVertices + 2, -1);
+    vector<bool> closed(numVertices + 2, false);
+    // (path cost + heuristic, node), smallest on top. Entries made stale by
+    // a later improvement are skipped when popped.
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> open;
+    
+    auto relax = [&](int from, int to, double length) {
+        double cost = pathCost[from] + length;
+        if (cost < pathCost[to]) {
+            pathCost[to] = cost;
+            parent[to] = from;
+            const Vertex &position = to == goalNode ? *goal
+                                                    : *graph.vertex(to);
+            open.push(QueueEntry(cost + distanceFormula(position, *goal),
+                                 to));
+        }
+    };
+    
+    pathCost[startNode] = 0;
+    open.push(QueueEntry(distanceFormula(*start, *goal),
+                         startNode));
+    while (!open.empty()) {
+        int u = open.top().second;
+        open.pop();
+        if (closed[u]) {
+            continue;
+        }
+        closed[u] = true;
+        ++nodesExpanded;
+        
+        if (u == goalNode) {
+            break;
+        }
+        if (u == startNode) {
+            for (int v = 0; v < numVertices; ++v) {
+                if (startSees[v] < infinity) {
+                    relax(u, v, startSees[v]);
+                }
+            }
+            continue;
+        }
+        
+        const MappedEdge *end = graph.edgesEnd(u);
+        for (const MappedEdge *e = graph.edgesBegin(u); e != end; ++e) {
+            relax(u, e->target, e->length);
+        }
+        if (goalSees[u] < infinity) {
+            relax(u, goalNode, goalSees[u]);
+        }
+    }
+    
+    if (pathCost[goalNode] == infinity) {
+        return -1;
+    }
+    
+    // Parents lead from goal back to start, the order solution wants
+    for (int node = goalNode; node != -1; node = parent[node]) {
+        const Vertex *position = node == startNode ? start :
+                                 node == goalNode ? goal : graph.vertex(node);
+        solution.push_back(State{position});
+    }
+    return pathCost[goalNode];
+}
@@ -0,0 +1,130 @@
+//
+//  streaming.h
+//  Visibility Graph Path Planning
+//
+//  Out-of-core visibility graph build. The polygons and vertices take space
+//  linear in the map size and stay in memory (every visibility test needs
+//  them), but the edges grow quadratically, so they are never all held at
+//  once. Source vertices are processed in order and their edges collected in
+//  a buffer of bounded size. Each time the buffer fills it is sorted and
+//  spilled to a run file, and the runs are merged into one adjacency file in
+//  compressed sparse row form. The file is then memory-mapped, and
+//  mappedSearch runs A* on it directly, so the operating system pages edges
+//  in as the search touches them.
+//
+
+#ifndef streaming_h
+#define streaming_h
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "preprocessing.h"
+#include "AStarState.h"
+
+// Start of an adjacency file. It is followed by numVertices Vertex records,
+// numVertices + 1 edge offsets (uint64_t), then numEdges MappedEdge records
+// sorted by source vertex. Each undirected edge is stored once per endpoint.
+struct MappedHeader {
+    char magic[8];
+    int64_t numVertices;
+    int64_t numEdges;
+};
+
+// One directed entry of the adjacency file
+struct MappedEdge {
+    int32_t target;
+    int32_t unused;
+    double length;
+};
+
+// What a streaming build did
+struct StreamingStats {
+    // Directed edge entries written (twice the number of Graph edges)
+    int64_t numEdges;
+    // Sorted runs spilled before merging
+    int numRuns;
+    // Largest number of bytes the edge buffer held
+    size_t peakBufferBytes;
+};
+
+// REQUIRES: polygons contains valid polygon obstacles, memoryBudget is at
+//           least sizeof(MappedEdge) * 2
+// MODIFIES: stats, visibleCounter, the file at path (and temporary run files
+//           next to it)
+// EFFECTS : Writes the visibility graph of polygons (the same edges
+//           preProcess builds) to an adjacency file at path, holding at most
+//           memoryBudget bytes of edges in memory at a time. The sorted runs
+//           are merged in passes of at most 64 runs, fewer if the budget
+//           cannot give each run a block of 256 edges, and the runs being
+//           merged share the budget. Adds the number of loops run by visible
+//           to visibleCounter. Returns false if a file could not be written
+//           or read back, or if the merge did not return every edge.
+bool streamingBuild(List<List<Vertex>> const &polygons,
+                    const std::string &path, size_t memoryBudget,
+                    StreamingStats &stats, int &visibleCounter);
+
+// Read-only view of an adjacency file
+class MappedGraph {
+private:
+    // The whole file (memory-mapped where the OS supports it)
+    void *data;
+    size_t bytes;
+    // Holds the file on systems without mmap
+    std::vector<char> fallback;
+    
+    const MappedHeader *header;
+    const Vertex *vertexArray;
+    const uint64_t *offsetArray;
+    const MappedEdge *edgeArray;
+    
+public:
+    // Constructs a MappedGraph with no file open
+    MappedGraph();
+    
+    // Unmaps the file
+    ~MappedGraph();
+    
+    // Mappings are not shared
+    MappedGraph(const MappedGraph &other) = delete;
+    MappedGraph & operator=(const MappedGraph &rhs) = delete;
+    
+    // REQUIRES: no file is open
+    // MODIFIES: this
+    // EFFECTS : Maps the adjacency file at path. Returns false if it could not
+    //           be opened or is not an adjacency file.
+    bool open(const std::string &path);
+    
+    // MODIFIES: this
+    // EFFECTS : Unmaps the file, if one is open
+    void close();
+    
+    // REQUIRES: a file is open
+    // EFFECTS : Returns the number of vertices
+    int numVertices() const;
+    
+    // REQUIRES: a file is open, 0 <= v < numVertices()
+    // EFFECTS : Returns vertex v (valid until the file is closed)
+    const Vertex* vertex(int v) const;
+    
+    // REQUIRES: a file is open, 0 <= v < numVertices()
+    // EFFECTS : Returns the first of v's edges and one past the last
+    const MappedEdge* edgesBegin(int v) const;
+    const MappedEdge* edgesEnd(int v) const;
+};
+
+// REQUIRES: graph is open and was built from polygons, start and goal are not
+//           in the interior of a polygon, solution is empty
+// MODIFIES: solution, nodesExpanded
+// EFFECTS : Attaches start and goal to the mapped graph (keeping their edges
+//           in memory) and runs A* over it. solution becomes the path from
+//           goal back to start (the order AStarSearch uses), with pointers
+//           into the mapping, or empty on failure. Adds the number of
+//           vertices expanded to nodesExpanded. Returns the path cost, or -1
+//           on failure.
+double mappedSearch(const MappedGraph &graph,
+                    List<List<Vertex>> const &polygons, Vertex *start,
+                    Vertex *goal, std::vector<State> &solution,
+                    int &nodesExpanded);
+
+#endif /* streaming_h */
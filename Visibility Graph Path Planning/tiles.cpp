@@ -0,0 +1,455 @@
+//
+//  tiles.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include "tiles.h"
+
+using namespace std;
+
+// Points closer than this to a polygon's boundary count as blocked
+static const double PORTAL_CLEARANCE = 1e-9;
+
+// Constructs an empty tile
+Tile::Tile() :
+polygons(false) {}
+
+// EFFECTS : Returns the index of the tile containing v (points on a border
+//           belong to the tile above or to the right of it, points outside
+//           the plane to the nearest tile)
+static int tileOf(const TiledGraph &tiled, const Vertex &v) {
+    const double side = (tiled.planeHigh - tiled.planeLow) /
+                        tiled.tilesPerSide;
+    int cell[DIMENSIONS];
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        cell[i] = (int) floor((v.coord[i] - tiled.planeLow) / side);
+        cell[i] = max(0, min(tiled.tilesPerSide - 1, cell[i]));
+    }
+    return cell[1] * tiled.tilesPerSide + cell[0];
+}
+
+// REQUIRES: polygon is a convex polygon
+// EFFECTS : Returns true if p is inside polygon or on its boundary
+static bool insidePolygon(const Vertex &p, const List<Vertex> &polygon) {
+    bool positive = false;
+    bool negative = false;
+    List<Vertex>::Iterator begin = polygon.begin();
+    List<Vertex>::Iterator v1 = begin;
+    for (int j = 0; j < polygon.size(); ++j) {
+        List<Vertex>::Iterator v2 = v1;
+        v2.circularIncrement(begin);
+        
+        double cross = ((*v2)->coord[0] - (*v1)->coord[0]) *
+                       (p.coord[1] - (*v1)->coord[1]) -
+                       ((*v2)->coord[1] - (*v1)->coord[1]) *
+                       (p.coord[0] - (*v1)->coord[0]);
+        if (cross > PORTAL_CLEARANCE) {
+            positive = true;
+        } else if (cross < -PORTAL_CLEARANCE) {
+            negative = true;
+        }
+        v1 = v2;
+    }
+    // Outside points are on the right of some edge and the left of another
+    return !(positive && negative);
+}
+
+// EFFECTS : Returns true if the bounding box of polygon touches tile
+static bool overlapsTile(const List<Vertex> &polygon, const Tile &tile) {
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        double low = numeric_limits<double>::infinity();
+        double high = -low;
+        List<Vertex>::Iterator end = polygon.end();
+        for (List<Vertex>::Iterator v = polygon.begin(); v != end; ++v) {
+            low = min(low, (*v)->coord[i]);
+            high = max(high, (*v)->coord[i]);
+        }
+        if (high < tile.low[i] || low > tile.high[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// REQUIRES: polygons is as for buildTiledGraph, tiled.tiles has been sized
+// MODIFIES: tiled
+// EFFECTS : Builds every stride-th tile starting from first (one thread's
+//           share of buildTiledGraph)
+static void buildTileShare(TiledGraph &tiled,
+                           List<List<Vertex>> const &polygons, int first,
+                           int stride) {
+    for (int t = first; t < (int) tiled.tiles.size(); t += stride) {
+        rebuildTile(tiled, polygons, t);
+    }
+}
+
+// REQUIRES: polygons contains valid polygon objects that lie inside the square
+//           [planeLow, planeHigh], tilesPerSide > 0, portalsPerBorder > 0,
+//           numThreads > 0, tiled is empty
+// MODIFIES: tiled
+// EFFECTS : Places portalsPerBorder evenly spaced portals on every border
+//           between two tiles, then builds every tile with rebuildTile.
+//           Tiles are built by numThreads threads at once. polygons must
+//           outlive tiled.
+void buildTiledGraph(List<List<Vertex>> const &polygons, double planeLow,
+                     double planeHigh, int tilesPerSide, int portalsPerBorder,
+                     int numThreads, TiledGraph &tiled) {
+    // Tiles and portal borders are laid out in the plane
+    static_assert(DIMENSIONS == 2, "tiles are laid out in the plane");
+    assert(tilesPerSide > 0 && portalsPerBorder > 0 && numThreads > 0);
+    assert(tiled.tiles.empty());
+    
+    tiled.planeLow = planeLow;
+    tiled.planeHigh = planeHigh;
+    tiled.tilesPerSide = tilesPerSide;
+    const double side = (planeHigh - planeLow) / tilesPerSide;
+    
+    for (int row = 0; row < tilesPerSide; ++row) {
+        for (int col = 0; col < tilesPerSide; ++col) {
+            unique_ptr<Tile> tile(new Tile);
+            tile->low[0] = planeLow + col * side;
+            tile->low[1] = planeLow + row * side;
+            tile->high[0] = tile->low[0] + side;
+            tile->high[1] = tile->low[1] + side;
+            tiled.tiles.push_back(move(tile));
+        }
+    }
+    
+    // Portals on the right border (x fixed) and top border (y fixed) of
+    // each tile that has a neighbor there
+    for (int row = 0; row < tilesPerSide; ++row) {
+        for (int col = 0; col < tilesPerSide; ++col) {
+            const int tile = row * tilesPerSide + col;
+            for (int k = 0; k < portalsPerBorder; ++k) {
+                const double along = (k + 0.5) * side / portalsPerBorder;
+                if (col + 1 < tilesPerSide) {
+                    Vertex portal = {{planeLow + (col + 1) * side,
+                                      planeLow + row * side + along},
+                                     -1, -1, -1};
+                    snapToGrid(portal);
+                    tiled.portals.push_back(portal);
+                    tiled.portalTiles.push_back(vector<int>{tile, tile + 1});
+                }
+                if (row + 1 < tilesPerSide) {
+                    Vertex portal = {{planeLow + col * side + along,
+                                      planeLow + (row + 1) * side},
+                                     -1, -1, -1};
+                    snapToGrid(portal);
+                    tiled.portals.push_back(portal);
+                    tiled.portalTiles.push_back(
+                        vector<int>{tile, tile + tilesPerSide});
+                }
+            }
+        }
+    }
+    
+    // Each tile only writes to itself, so the shares are independent
+    vector<thread> builders;
+    for (int k = 1; k < numThreads; ++k) {
+        builders.push_back(thread(buildTileShare, ref(tiled), cref(polygons),
+                                  k, numThreads));
+    }
+    buildTileShare(tiled, polygons, 0, numThreads);
+    for (int k = 0; k < (int) builders.size(); ++k) {
+        builders[k].join();
+    }
+}
+
+// REQUIRES: tiled was built by buildTiledGraph, 0 <= tileIndex < number of
+//           tiles, polygons is as for buildTiledGraph (it may differ from the
+//           list tiled was built from in the polygons overlapping this tile)
+// MODIFIES: tiled
+// EFFECTS : Rebuilds the local graph and portal distances of one tile from the
+//           polygons overlapping it. Only that tile is touched, so different
+//           tiles can be rebuilt at the same time.
+void rebuildTile(TiledGraph &tiled, List<List<Vertex>> const &polygons,
+                 int tileIndex) {
+    assert(tileIndex >= 0 && tileIndex < (int) tiled.tiles.size());
+    
+    // Build a replacement, keeping only the corners of the old tile
+    unique_ptr<Tile> tile(new Tile);
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        tile->low[i] = tiled.tiles[tileIndex]->low[i];
+        tile->high[i] = tiled.tiles[tileIndex]->high[i];
+    }
+    
+    // Traversal by Iterator
+    List<List<Vertex>>::Iterator endP = polygons.end();
+    for (List<List<Vertex>>::Iterator pgon = polygons.begin(); pgon != endP;
+         ++pgon) {
+        if (!overlapsTile(**pgon, *tile)) {
+            continue;
+        }
+        tile->polygons.insertEnd(*pgon);
+        
+        List<Vertex>::Iterator endV = (*pgon)->end();
+        for (List<Vertex>::Iterator v = (*pgon)->begin(); v != endV; ++v) {
+            if (tileOf(tiled, **v) == tileIndex) {
+                Vertex *newVert = new Vertex;
+                *newVert = **v;
+                tile->graph.vertices.insertEnd(newVert);
+            }
+        }
+    }
+    
+    // Portals of this tile that no polygon covers
+    vector<const Vertex*> portalCopies;
+    for (int p = 0; p < (int) tiled.portals.size(); ++p) {
+        const vector<int> &sharing = tiled.portalTiles[p];
+        if (find(sharing.begin(), sharing.end(), tileIndex) == sharing.end()) {
+            continue;
+        }
+        bool blocked = false;
+        List<List<Vertex>>::Iterator endT = tile->polygons.end();
+        for (List<List<Vertex>>::Iterator pgon = tile->polygons.begin();
+             pgon != endT && !blocked; ++pgon) {
+            blocked = insidePolygon(tiled.portals[p], **pgon);
+        }
+        if (blocked) {
+            continue;
+        }
+        Vertex *newVert = new Vertex;
+        *newVert = tiled.portals[p];
+        tile->graph.vertices.insertEnd(newVert);
+        tile->portalSlot[p] = (int) tile->portalIds.size();
+        tile->portalIds.push_back(p);
+        portalCopies.push_back(newVert);
+    }
+    
+    // Need dummy counters (see testing code for actual use)
+    int dummyCounter = 0;
+    makeConnections(tile->graph, tile->polygons, dummyCounter, dummyCounter,
+                    dummyCounter);
+    buildAdjacency(tile->graph, tile->adjacency);
+    
+    const int numPortals = (int) portalCopies.size();
+    tile->portalVertices.resize(numPortals);
+    tile->portalDistances.resize(numPortals);
+    tile->portalPrevious.resize(numPortals);
+    for (int i = 0; i < numPortals; ++i) {
+        tile->portalVertices[i] = vertexIndex(tile->adjacency,
+                                              portalCopies[i]);
+        shortestPaths(tile->adjacency, tile->portalVertices[i],
+                      tile->portalDistances[i], tile->portalPrevious[i],
+                      dummyCounter);
+    }
+    
+    tiled.tiles[tileIndex] = move(tile);
+}
+
+// REQUIRES: point is inside tile and not in the interior of a polygon
+// MODIFIES: local
+// EFFECTS : Sets local to base with point added and connected to every vertex
+//           of base it can see. Returns point's index in local.
+static int attachPoint(const Tile &tile, const AdjacencyGraph &base,
+                       const Vertex *point, AdjacencyGraph &local) {
+    local = base;
+    const int pointIndex = (int) local.vertices.size();
+    local.vertices.push_back(point);
+    local.neighbors.push_back(vector<Neighbor>());
+    local.index[point] = pointIndex;
+    
+    int dummyCounter = 0;
+    for (int v = 0; v < pointIndex; ++v) {
+        if (visible(*point, *local.vertices[v], tile.polygons,
+                    dummyCounter)) {
+            double distance = distanceFormula(*point, *local.vertices[v]);
+            local.neighbors[pointIndex].push_back(Neighbor{v, distance});
+            local.neighbors[v].push_back(Neighbor{pointIndex, distance});
+        }
+    }
+    return pointIndex;
+}
+
+// REQUIRES: previous is from a shortest path search of adjacency rooted at
+//           some source, target was reached
+// MODIFIES: path
+// EFFECTS : Appends the path from source to target to path, without source
+static void appendPathTo(const AdjacencyGraph &adjacency,
+                         const vector<int> &previous, int target,
+                         vector<const Vertex*> &path) {
+    vector<const Vertex*> reversed;
+    for (int v = target; previous[v] != -1; v = previous[v]) {
+        reversed.push_back(adjacency.vertices[v]);
+    }
+    path.insert(path.end(), reversed.rbegin(), reversed.rend());
+}
+
+// REQUIRES: previous is from a shortest path search of adjacency rooted at
+//           some source, from was reached
+// MODIFIES: path
+// EFFECTS : Appends the path from from to the source to path, without from
+static void appendPathFrom(const AdjacencyGraph &adjacency,
+                           const vector<int> &previous, int from,
+                           vector<const Vertex*> &path) {
+    for (int v = previous[from]; v != -1; v = previous[v]) {
+        path.push_back(adjacency.vertices[v]);
+    }
+}
+
+// REQUIRES: start and goal are inside the plane and not in the interior of a
+//           polygon, solution is empty
+// MODIFIES: solution, nodesSettled
+// EFFECTS : Searches the abstract portal graph from start to goal (and the
+//           shared tile directly if both are in one tile), then refines the
+//           best route into tile paths. solution becomes the path from goal
+//           back to start (the order AStarSearch uses), or empty on failure.
+//           Adds the number of portals settled to nodesSettled. Returns the
+//           path cost, or -1 on failure.
+double tiledSearch(const TiledGraph &tiled, Vertex *start, Vertex *goal,
+                   std::vector<State> &solution, int &nodesSettled) {
+    assert(solution.empty());
+    
+    const double infinity = numeric_limits<double>::infinity();
+    const int startTile = tileOf(tiled, *start);
+    const int goalTile = tileOf(tiled, *goal);
+    const Tile &sTile = *tiled.tiles[startTile];
+    const Tile &gTile = *tiled.tiles[goalTile];
+    
+    // Distances from start within its tile and from goal within its tile.
+    // When they share a tile, both are attached to the same local graph.
+    int dummyCounter = 0;
+    AdjacencyGraph startLocal;
+    AdjacencyGraph goalLocal;
+    int startIndex = attachPoint(sTile, sTile.adjacency, start, startLocal);
+    int goalIndex = -1;
+    if (startTile == goalTile) {
+        goalIndex = attachPoint(sTile, startLocal, goal, goalLocal);
+        startLocal = goalLocal;
+    } else {
+        goalIndex = attachPoint(gTile, gTile.adjacency, goal, goalLocal);
+    }
+    vector<double> startDistances, goalDistances;
+    vector<int> startPrevious, goalPrevious;
+    shortestPaths(startLocal, startIndex, startDistances, startPrevious,
+                  dummyCounter);
+    shortestPaths(goalLocal, goalIndex, goalDistances, goalPrevious,
+                  dummyCounter);
+    
+    // Dijkstra over the portals, with the goal as one extra node. Each node
+    // remembers the node before it (-1 for start) and the tile the abstract
+    // edge between them crosses.
+    const int goalNode = (int) tiled.portals.size();
+    vector<double> distances(goalNode + 1, infinity);
+    vector<int> previousNode(goalNode + 1, -1);
+    vector<int> previousTile(goalNode + 1, -1);
+    typedef pair<double, int> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> queue;
+    
+    for (int i = 0; i < (int) sTile.portalIds.size(); ++i) {
+        double distance = startDistances[sTile.portalVertices[i]];
+        if (distance < infinity) {
+            int p = sTile.portalIds[i];
+            distances[p] = distance;
+            previousTile[p] = startTile;
+            queue.push(QueueEntry(distance, p));
+        }
+    }
+    if (startTile == goalTile && startDistances[goalIndex] < infinity) {
+        distances[goalNode] = startDistances[goalIndex];
+        previousTile[goalNode] = startTile;
+        queue.push(QueueEntry(distances[goalNode], goalNode));
+    }
+    
+    while (!queue.empty()) {
+        QueueEntry top = queue.top();
+        queue.pop();
+        
+        int u = top.second;
+        if (top.first > distances[u]) {
+            // Stale entry
+            continue;
+        }
+        ++nodesSettled;
+        if (u == goalNode) {
+            break;
+        }
+        
+        for (int k = 0; k < (int) tiled.portalTiles[u].size(); ++k) {
+            const int t = tiled.portalTiles[u][k];
+            const Tile &tile = *tiled.tiles[t];
+            unordered_map<int, int>::const_iterator slot =
+                tile.portalSlot.find(u);
+            if (slot == tile.portalSlot.end()) {
+                // Blocked on this side
+                continue;
+            }
+            const vector<double> &fromU = tile.portalDistances[slot->second];
+            
+            for (int j = 0; j < (int) tile.portalIds.size(); ++j) {
+                int q = tile.portalIds[j];
+                double distance = top.first + fromU[tile.portalVertices[j]];
+                if (distance < distances[q]) {
+                    distances[q] = distance;
+                    previousNode[q] = u;
+                    previousTile[q] = t;
+                    queue.push(QueueEntry(distance, q));
+                }
+            }
+            if (t == goalTile) {
+                double distance = top.first +
+                    goalDistances[tile.portalVertices[slot->second]];
+                if (distance < distances[goalNode]) {
+                    distances[goalNode] = distance;
+                    previousNode[goalNode] = u;
+                    previousTile[goalNode] = t;
+                    queue.push(QueueEntry(distance, goalNode));
+                }
+            }
+        }
+    }
+    
+    if (distances[goalNode] == infinity) {
+        return -1;
+    }
+    
+    // Abstract route from the first portal to the goal node
+    vector<int> route;
+    for (int node = goalNode; node != -1; node = previousNode[node]) {
+        route.push_back(node);
+    }
+    reverse(route.begin(), route.end());
+    
+    // Refine every abstract edge into the path through its tile
+    vector<const Vertex*> path;
+    path.push_back(start);
+    if (route.size() == 1) {
+        // Start and goal connected inside their shared tile
+        appendPathTo(startLocal, startPrevious, goalIndex, path);
+    } else {
+        const int firstSlot = sTile.portalSlot.at(route[0]);
+        appendPathTo(startLocal, startPrevious,
+                     sTile.portalVertices[firstSlot], path);
+        
+        for (int k = 1; k + 1 < (int) route.size(); ++k) {
+            const Tile &tile = *tiled.tiles[previousTile[route[k]]];
+            const int fromSlot = tile.portalSlot.at(route[k - 1]);
+            const int toSlot = tile.portalSlot.at(route[k]);
+            // The portal is shared by two tiles, drop the other tile's copy
+            path.pop_back();
+            path.push_back(tile.adjacency.vertices[
+                tile.portalVertices[fromSlot]]);
+            appendPathTo(tile.adjacency, tile.portalPrevious[fromSlot],
+                         tile.portalVertices[toSlot], path);
+        }
+        
+        const int lastSlot = gTile.portalSlot.at(route[route.size() - 2]);
+        path.pop_back();
+        path.push_back(gTile.adjacency.vertices[
+            gTile.portalVertices[lastSlot]]);
+        appendPathFrom(goalLocal, goalPrevious,
+                       gTile.portalVertices[lastSlot], path);
+    }
+    
+    for (int i = (int) path.size() - 1; i >= 0; --i) {
+        solution.push_back(State{path[i]});
+    }
+    return distances[goalNode];
+}
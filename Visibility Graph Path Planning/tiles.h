@@ -0,0 +1,97 @@
+//
+//  tiles.h
+//  Visibility Graph Path Planning
+//
+//  Hierarchical visibility graph for maps too large for one flat graph. The
+//  square plane is cut into tiles, and portal points are placed along the
+//  borders between neighboring tiles. Each tile gets its own visibility graph
+//  of the polygon vertices inside it and its portals. A segment between two
+//  points of a tile stays inside the tile, so only the polygons overlapping
+//  the tile have to be tested. The distances between every pair of a tile's
+//  portals are stored, which makes the portals an abstract graph. A query
+//  searches that abstract graph from start to goal and then refines each
+//  abstract edge into the tile path it stands for. Paths are forced through
+//  portals, so they are close to, but not always, the shortest path.
+//
+
+#ifndef tiles_h
+#define tiles_h
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "preprocessing.h"
+#include "adjacency.h"
+#include "AStarState.h"
+
+struct Tile {
+    // Corners of the tile
+    double low[DIMENSIONS];
+    double high[DIMENSIONS];
+    // Polygons that overlap the tile (not owned)
+    List<List<Vertex>> polygons;
+    // Local visibility graph: the polygon vertices in the tile and its
+    // portals that are not blocked by a polygon
+    Graph graph;
+    AdjacencyGraph adjacency;
+    // Portal id and adjacency index of each usable portal, and the reverse
+    // lookup from portal id to position in these vectors
+    std::vector<int> portalIds;
+    std::vector<int> portalVertices;
+    std::unordered_map<int, int> portalSlot;
+    // portalDistances[i][v] and portalPrevious[i][v] are the shortest path
+    // distance and previous vertex from portal i to vertex v of adjacency
+    std::vector<std::vector<double>> portalDistances;
+    std::vector<std::vector<int>> portalPrevious;
+    
+    // Constructs an empty tile
+    Tile();
+};
+
+struct TiledGraph {
+    // The plane is the square [planeLow, planeHigh] in every dimension, cut
+    // into tilesPerSide x tilesPerSide tiles (row-major, x first)
+    double planeLow;
+    double planeHigh;
+    int tilesPerSide;
+    std::vector<std::unique_ptr<Tile>> tiles;
+    // Portal points (polygon index -1), and the two tiles sharing each
+    std::vector<Vertex> portals;
+    std::vector<std::vector<int>> portalTiles;
+};
+
+// REQUIRES: polygons contains valid polygon objects that lie inside the square
+//           [planeLow, planeHigh], tilesPerSide > 0, portalsPerBorder > 0,
+//           numThreads > 0, tiled is empty
+// MODIFIES: tiled
+// EFFECTS : Places portalsPerBorder evenly spaced portals on every border
+//           between two tiles, then builds every tile with rebuildTile.
+//           Tiles are built by numThreads threads at once. polygons must
+//           outlive tiled.
+void buildTiledGraph(List<List<Vertex>> const &polygons, double planeLow,
+                     double planeHigh, int tilesPerSide, int portalsPerBorder,
+                     int numThreads, TiledGraph &tiled);
+
+// REQUIRES: tiled was built by buildTiledGraph, 0 <= tileIndex < number of
+//           tiles, polygons is as for buildTiledGraph (it may differ from the
+//           list tiled was built from in the polygons overlapping this tile)
+// MODIFIES: tiled
+// EFFECTS : Rebuilds the local graph and portal distances of one tile from the
+//           polygons overlapping it. Only that tile is touched, so different
+//           tiles can be rebuilt at the same time.
+void rebuildTile(TiledGraph &tiled, List<List<Vertex>> const &polygons,
+                 int tileIndex);
+
+// REQUIRES: start and goal are inside the plane and not in the interior of a
+//           polygon, solution is empty
+// MODIFIES: solution, nodesSettled
+// EFFECTS : Searches the abstract portal graph from start to goal (and the
+//           shared tile directly if both are in one tile), then refines the
+//           best route into tile paths. solution becomes the path from goal
+//           back to start (the order AStarSearch uses), or empty on failure.
+//           Adds the number of portals settled to nodesSettled. Returns the
+//           path cost, or -1 on failure.
+double tiledSearch(const TiledGraph &tiled, Vertex *start, Vertex *goal,
+                   std::vector<State> &solution, int &nodesSettled);
+
+#endif /* tiles_h */
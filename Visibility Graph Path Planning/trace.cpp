@@ -0,0 +1,132 @@
+//
+//  trace.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include "trace.h"
+
+using namespace std;
+
+atomic<bool> traceEnabled(false);
+
+// One begin ('B') or end ('E') event
+struct TraceEvent {
+    const char *name;
+    char phase;
+    long index;
+    // Microseconds since startTrace
+    double timestamp;
+};
+
+// Events of one thread
+struct TraceBuffer {
+    int threadId;
+    vector<TraceEvent> events;
+};
+
+// Every thread's buffer (kept after the thread exits) and the start of the
+// trace clock. The lock is only taken when a thread records its first event
+// and when the trace is restarted or written.
+static mutex traceMutex;
+static vector<unique_ptr<TraceBuffer>> traceBuffers;
+static chrono::steady_clock::time_point traceStart;
+
+// The calling thread's buffer, once it has recorded an event
+static thread_local TraceBuffer *threadBuffer = nullptr;
+
+// EFFECTS : Returns the calling thread's buffer, registering one the first
+//           time
+static TraceBuffer & buffer() {
+    if (!threadBuffer) {
+        lock_guard<mutex> lock(traceMutex);
+        traceBuffers.emplace_back(new TraceBuffer);
+        threadBuffer = traceBuffers.back().get();
+        threadBuffer->threadId = (int) traceBuffers.size() - 1;
+    }
+    return *threadBuffer;
+}
+
+// EFFECTS : Returns the microseconds since startTrace
+static double traceClock() {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() -
+                                           traceStart).count();
+}
+
+// MODIFIES: the trace
+// EFFECTS : Discards any recorded events, restarts the trace clock and turns
+//           tracing on
+void startTrace() {
+    lock_guard<mutex> lock(traceMutex);
+    // Buffers stay registered to their threads; only their events go
+    for (unique_ptr<TraceBuffer> &threadEvents : traceBuffers) {
+        threadEvents->events.clear();
+    }
+    traceStart = chrono::steady_clock::now();
+    traceEnabled = true;
+}
+
+// MODIFIES: the trace
+// EFFECTS : Turns tracing off (recorded events are kept)
+void stopTrace() {
+    traceEnabled = false;
+}
+
+// REQUIRES: name is a string literal (or otherwise outlives the trace)
+// MODIFIES: the trace
+// EFFECTS : Records the begin of phase name on the calling thread, with
+//           index as its argument if index >= 0. Does nothing unless
+//           traceEnabled.
+void traceBegin(const char *name, long index) {
+    if (traceEnabled.load(memory_order_relaxed)) {
+        buffer().events.push_back(TraceEvent{name, 'B', index, traceClock()});
+    }
+}
+
+// REQUIRES: a phase named name was begun (and recorded) on the calling
+//           thread
+// MODIFIES: the trace
+// EFFECTS : Records the end of phase name on the calling thread, even if
+//           tracing was turned off since it began, so every begin has an
+//           end
+void traceEnd(const char *name) {
+    buffer().events.push_back(TraceEvent{name, 'E', -1, traceClock()});
+}
+
+// REQUIRES: no thread is recording events
+// EFFECTS : Writes every recorded event to the file at path as Chrome trace
+//           JSON. Returns false if the file could not be written.
+bool writeTrace(const std::string &path) {
+    ofstream os(path);
+    if (!os) {
+        return false;
+    }
+    lock_guard<mutex> lock(traceMutex);
+    os.precision(15);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const unique_ptr<TraceBuffer> &threadEvents : traceBuffers) {
+        // Name the thread (numbered in the order threads first recorded)
+        os << (first ? "\n" : ",\n")
+           << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+           << threadEvents->threadId << ",\"args\":{\"name\":\"thread "
+           << threadEvents->threadId << "\"}}";
+        first = false;
+        for (const TraceEvent &event : threadEvents->events) {
+            // Phase names are literals without characters JSON escapes
+            os << ",\n{\"name\":\"" << event.name << "\",\"ph\":\""
+               << event.phase << "\",\"ts\":" << event.timestamp
+               << ",\"pid\":1,\"tid\":" << threadEvents->threadId;
+            if (event.index >= 0) {
+                os << ",\"args\":{\"index\":" << event.index << "}";
+            }
+            os << "}";
+        }
+    }
+    os << "\n]}\n";
+    return (bool) os;
+}
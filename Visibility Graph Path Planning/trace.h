@@ -0,0 +1,82 @@
+//
+//  trace.h
+//  Visibility Graph Path Planning
+//
+//  Optional trace of where the time goes inside a run, written in the Chrome
+//  trace event format (open the file in Perfetto or chrome://tracing). Each
+//  traced phase records a begin and an end event with a timestamp and the
+//  thread it ran on. Threads record into their own buffers, so tracing takes
+//  no locks after a thread's first event. While tracing is off, a
+//  TraceScope costs one test of traceEnabled.
+//
+
+#ifndef trace_h
+#define trace_h
+
+#include <string>
+#include <atomic>
+
+// True between startTrace and stopTrace. Only read it (a relaxed load is
+// enough); use startTrace and stopTrace to change it.
+extern std::atomic<bool> traceEnabled;
+
+// MODIFIES: the trace
+// EFFECTS : Discards any recorded events, restarts the trace clock and turns
+//           tracing on
+void startTrace();
+
+// MODIFIES: the trace
+// EFFECTS : Turns tracing off (recorded events are kept)
+void stopTrace();
+
+// REQUIRES: name is a string literal (or otherwise outlives the trace)
+// MODIFIES: the trace
+// EFFECTS : Records the begin of phase name on the calling thread, with
+//           index as its argument if index >= 0. Does nothing unless
+//           traceEnabled.
+void traceBegin(const char *name, long index = -1);
+
+// REQUIRES: a phase named name was begun (and recorded) on the calling
+//           thread
+// MODIFIES: the trace
+// EFFECTS : Records the end of phase name on the calling thread, even if
+//           tracing was turned off since it began, so every begin has an
+//           end
+void traceEnd(const char *name);
+
+// REQUIRES: no thread is recording events
+// EFFECTS : Writes every recorded event to the file at path as Chrome trace
+//           JSON. Returns false if the file could not be written.
+bool writeTrace(const std::string &path);
+
+// Traces the phase it is in scope for. Tracing is checked once, when the
+// scope begins.
+class TraceScope {
+private:
+    // Phase being traced (nullptr if tracing was off)
+    const char *name;
+
+public:
+    // REQUIRES: name is a string literal
+    // EFFECTS : Begins phase name (with index, see traceBegin) if tracing is
+    //           on
+    explicit TraceScope(const char *name, long index = -1)
+    : name(traceEnabled.load(std::memory_order_relaxed) ? name : nullptr) {
+        if (this->name) {
+            traceBegin(name, index);
+        }
+    }
+
+    // EFFECTS : Ends the phase, if one was begun
+    ~TraceScope() {
+        if (name) {
+            traceEnd(name);
+        }
+    }
+
+    // A phase ends once
+    TraceScope(const TraceScope &other) = delete;
+    TraceScope & operator=(const TraceScope &rhs) = delete;
+};
+
+#endif /* trace_h */
@@ -0,0 +1,471 @@
+//
+//  validate.cpp
+//  Visibility Graph Path Planning
+//
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <unordered_map>
+#include <functional>
+#include "validate.h"
+
+using namespace std;
+
+// A polygon as validatePolygons sees it
+struct PolygonData {
+    // Polygon index (see Vertex)
+    int index;
+    vector<const Vertex*> vertices;
+    // Bounding box
+    double low[DIMENSIONS];
+    double high[DIMENSIONS];
+    // Turn direction of the polygon (see orientationSign), 0 if it is not
+    // convex
+    int sign;
+};
+
+// A polygon edge with its bounding box
+struct EdgeBox {
+    double low[DIMENSIONS];
+    double high[DIMENSIONS];
+    // Position of the edge's polygon in the PolygonData list
+    int polygon;
+    const Vertex *a;
+    const Vertex *b;
+};
+
+// Most grid cells per box, so sparse maps of small obstacles do not get a
+// huge mostly empty grid
+static const int MAX_CELLS_PER_BOX = 4;
+
+// Uniform grid over a set of bounding boxes; each cell lists the boxes that
+// overlap it
+struct BoxGrid {
+    double low[DIMENSIONS];
+    double cellSize[DIMENSIONS];
+    // Number of cells along each axis
+    int cells[DIMENSIONS];
+    // The boxes overlapping cell c are
+    // cellBoxes[cellStart[c]] to cellBoxes[cellStart[c + 1] - 1]
+    vector<int> cellStart;
+    vector<int> cellBoxes;
+};
+
+// Hashes vertex coordinates (consistent with CoordinateEqual, so -0.0 and
+// 0.0 hash alike)
+struct CoordinateHash {
+    size_t operator()(const Vertex *v) const {
+        size_t seed = 0;
+        for (int i = 0; i < DIMENSIONS; ++i) {
+            const double coord = v->coord[i] == 0 ? 0.0 : v->coord[i];
+            seed ^= hash<double>()(coord) + 0x9e3779b9 + (seed << 6) +
+                    (seed >> 2);
+        }
+        return seed;
+    }
+};
+
+// Compares vertex coordinates
+struct CoordinateEqual {
+    bool operator()(const Vertex *lhs, const Vertex *rhs) const {
+        return *lhs == *rhs;
+    }
+};
+
+// EFFECTS : Returns true if the boxes [low1, high1] and [low2, high2]
+//           overlap in dimension i (touching counts)
+static bool boxesOverlap(const double *low1, const double *high1,
+                         const double *low2, const double *high2, int i) {
+    return low1[i] <= high2[i] && low2[i] <= high1[i];
+}
+
+// REQUIRES: grid was built
+// EFFECTS : Returns the cell along axis i that value falls in, clamped to
+//           the grid
+static int cellOf(const BoxGrid &grid, double value, int i) {
+    double cell = floor((value - grid.low[i]) / grid.cellSize[i]);
+    if (cell < 0) {
+        return 0;
+    }
+    if (cell >= grid.cells[i]) {
+        return grid.cells[i] - 1;
+    }
+    return (int) cell;
+}
+
+// REQUIRES: Boxed has low and high arrays of DIMENSIONS doubles, grid is
+//           empty
+// MODIFIES: grid
+// EFFECTS : Builds a grid over the bounding box of boxes and lists in each
+//           cell the boxes that overlap it. Cells are as large as the mean
+//           box along each axis, so long edges and wide obstacles still
+//           cover only a few cells, and grow if that would make more than
+//           MAX_CELLS_PER_BOX cells per box.
+template <class Boxed>
+static void buildBoxGrid(const vector<Boxed> &boxes, BoxGrid &grid) {
+    const int numBoxes = (int) boxes.size();
+    double high[DIMENSIONS];
+    double extent[DIMENSIONS];
+    double cellCount = 1;
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        grid.low[i] = numBoxes > 0 ? boxes[0].low[i] : 0;
+        high[i] = numBoxes > 0 ? boxes[0].high[i] : 0;
+        double totalSize = 0;
+        for (const Boxed &box : boxes) {
+            grid.low[i] = min(grid.low[i], box.low[i]);
+            high[i] = max(high[i], box.high[i]);
+            totalSize += box.high[i] - box.low[i];
+        }
+        extent[i] = high[i] - grid.low[i];
+        // At most numBoxes cells along an axis
+        grid.cellSize[i] = max(totalSize / max(numBoxes, 1),
+                               extent[i] / max(numBoxes, 1));
+        if (grid.cellSize[i] <= 0) {
+            grid.cellSize[i] = 1;
+        }
+        cellCount *= ceil(extent[i] / grid.cellSize[i]);
+    }
+    const double cellLimit = (double) MAX_CELLS_PER_BOX * max(numBoxes, 1);
+    const double scale = cellCount > cellLimit ?
+                         pow(cellCount / cellLimit, 1.0 / DIMENSIONS) : 1;
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        grid.cellSize[i] *= scale;
+        grid.cells[i] = max(1, (int) ceil(extent[i] / grid.cellSize[i]));
+    }
+
+    // Count the boxes in each cell, then fill the lists (counting sort)
+    const int numCells = grid.cells[0] * grid.cells[1];
+    grid.cellStart.assign(numCells + 1, 0);
+    vector<int> next;
+    for (int pass = 0; pass < 2; ++pass) {
+        if (pass == 1) {
+            for (int c = 0; c < numCells; ++c) {
+                grid.cellStart[c + 1] += grid.cellStart[c];
+            }
+            grid.cellBoxes.resize(grid.cellStart[numCells]);
+            next.assign(grid.cellStart.begin(), grid.cellStart.end() - 1);
+        }
+        for (int b = 0; b < numBoxes; ++b) {
+            int lowX = cellOf(grid, boxes[b].low[0], 0);
+            int lowY = cellOf(grid, boxes[b].low[1], 1);
+            int highX = cellOf(grid, boxes[b].high[0], 0);
+            int highY = cellOf(grid, boxes[b].high[1], 1);
+            for (int y = lowY; y <= highY; ++y) {
+                for (int x = lowX; x <= highX; ++x) {
+                    int cell = y * grid.cells[0] + x;
+                    if (pass == 0) {
+                        ++grid.cellStart[cell + 1];
+                    } else {
+                        grid.cellBoxes[next[cell]++] = b;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// REQUIRES: grid was built from boxes
+// EFFECTS : Calls visit(a, b) once for every pair of boxes a < b that
+//           overlap (touching counts). A pair can share many cells, so it
+//           is only visited in the cell holding the low corner of the two
+//           boxes' intersection.
+template <class Boxed, class Visit>
+static void forEachOverlappingPair(const vector<Boxed> &boxes,
+                                   const BoxGrid &grid, Visit visit) {
+    const int numCells = grid.cells[0] * grid.cells[1];
+    for (int cell = 0; cell < numCells; ++cell) {
+        for (int i = grid.cellStart[cell]; i < grid.cellStart[cell + 1];
+             ++i) {
+            const Boxed &first = boxes[grid.cellBoxes[i]];
+            for (int j = i + 1; j < grid.cellStart[cell + 1]; ++j) {
+                const Boxed &second = boxes[grid.cellBoxes[j]];
+                if (!boxesOverlap(first.low, first.high, second.low,
+                                  second.high, 0) ||
+                    !boxesOverlap(first.low, first.high, second.low,
+                                  second.high, 1)) {
+                    continue;
+                }
+                int corner =
+                    cellOf(grid, max(first.low[1], second.low[1]), 1) *
+                        grid.cells[0] +
+                    cellOf(grid, max(first.low[0], second.low[0]), 0);
+                if (corner == cell) {
+                    visit(min(grid.cellBoxes[i], grid.cellBoxes[j]),
+                          max(grid.cellBoxes[i], grid.cellBoxes[j]));
+                }
+            }
+        }
+    }
+}
+
+// REQUIRES: polygon has at least one vertex
+// EFFECTS : Returns the turn direction of polygon (1 or -1, see
+//           orientationSign) if it is convex and winds around once, 0
+//           otherwise. Collinear corners are allowed, repeated vertices are
+//           not.
+static int convexSign(const vector<const Vertex*> &polygon) {
+    const int size = (int) polygon.size();
+    if (size < 3) {
+        return 0;
+    }
+
+    int sign = 0;
+    // Changes in the direction the edges run along x; a convex polygon
+    // reverses twice, a polygon winding around more than once reverses more
+    int reversals = 0;
+    int lastDirection = 0;
+    int firstDirection = 0;
+    for (int i = 0; i < size; ++i) {
+        const Vertex &a = *polygon[i];
+        const Vertex &b = *polygon[(i + 1) % size];
+        const Vertex &c = *polygon[(i + 2) % size];
+        if (a == b) {
+            return 0;
+        }
+
+        int turn = orientationSign(a, b, c);
+        if (turn != 0) {
+            if (sign != 0 && turn != sign) {
+                return 0;
+            }
+            sign = turn;
+        }
+
+        int direction = (b.coord[0] > a.coord[0]) - (b.coord[0] < a.coord[0]);
+        if (direction != 0) {
+            if (lastDirection != 0 && direction != lastDirection) {
+                ++reversals;
+            }
+            if (firstDirection == 0) {
+                firstDirection = direction;
+            }
+            lastDirection = direction;
+        }
+    }
+    // Close the loop from the last edge back to the first
+    if (firstDirection != 0 && firstDirection != lastDirection) {
+        ++reversals;
+    }
+    return reversals <= 2 ? sign : 0;
+}
+
+// REQUIRES: a, b, p are collinear
+// EFFECTS : Returns true if p lies on the closed segment [a, b]
+static bool onSegment(const Vertex &a, const Vertex &b, const Vertex &p) {
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        if (p.coord[i] < min(a.coord[i], b.coord[i]) ||
+            p.coord[i] > max(a.coord[i], b.coord[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// EFFECTS : Returns true if the closed segments [a1, a2] and [b1, b2] have a
+//           point in common (unlike intersect, touching counts)
+static bool segmentsMeet(const Vertex &a1, const Vertex &a2,
+                         const Vertex &b1, const Vertex &b2) {
+    int o1 = orientationSign(a1, a2, b1);
+    int o2 = orientationSign(a1, a2, b2);
+    int o3 = orientationSign(b1, b2, a1);
+    int o4 = orientationSign(b1, b2, a2);
+    // General case: each segment's endpoints are on different sides of (or
+    // on) the other's line
+    if (o1 != o2 && o3 != o4) {
+        return true;
+    }
+    // Collinear cases
+    return (o1 == 0 && onSegment(a1, a2, b1)) ||
+           (o2 == 0 && onSegment(a1, a2, b2)) ||
+           (o3 == 0 && onSegment(b1, b2, a1)) ||
+           (o4 == 0 && onSegment(b1, b2, a2));
+}
+
+// REQUIRES: polygon is convex (polygon.sign != 0)
+// EFFECTS : Returns true if point is inside polygon or on its boundary
+static bool insideOrOn(const PolygonData &polygon, const Vertex &point) {
+    const int size = (int) polygon.vertices.size();
+    for (int i = 0; i < size; ++i) {
+        if (orientationSign(*polygon.vertices[i],
+                            *polygon.vertices[(i + 1) % size], point) ==
+            -polygon.sign) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// EFFECTS : Returns (a, b) ordered with the smaller polygon index first
+static pair<int, int> polygonPair(int a, int b) {
+    return a < b ? make_pair(a, b) : make_pair(b, a);
+}
+
+// REQUIRES: polygons was read by read_polygons (or preProcess), report is
+//           empty
+// MODIFIES: report
+// EFFECTS : Checks each polygon for convexity in linear time (all turns in
+//           one direction, and the polygon winds around only once), checks
+//           that all polygons have the same orientation, finds polygons
+//           sharing a vertex with a hash of the coordinates, and finds
+//           overlapping or touching pairs: edges of different polygons whose
+//           bounding boxes overlap (found by bucketing the boxes in a uniform
+//           grid with cells about as large as the mean box) are tested for a
+//           common point, then polygons whose bounding boxes overlap (found
+//           the same way) are tested for containment. All tests use the
+//           exact orientation predicate. Takes O(N + C) time for N vertices
+//           and C pairs of edges (or polygons) sharing a grid cell, plus
+//           linear time per candidate polygon pair. C is near N unless many
+//           edges crowd into the same few cells. Returns true if no problems
+//           were found.
+bool validatePolygons(List<List<Vertex>> const &polygons,
+                      ValidationReport &report) {
+    // Convexity and containment are planar tests
+    static_assert(DIMENSIONS == 2, "polygons are validated in the plane");
+    assert(report.nonConvex.empty() && report.overlaps.empty());
+    report.candidatePairs = 0;
+
+    // Gather each polygon and check it on its own
+    vector<PolygonData> data;
+    data.reserve(polygons.size());
+    int referenceSign = 0;
+    List<List<Vertex>>::Iterator endP = polygons.end();
+    for (List<List<Vertex>>::Iterator pgon = polygons.begin(); pgon != endP;
+         ++pgon) {
+        PolygonData polygon;
+        List<Vertex>::Iterator endV = (*pgon)->end();
+        for (List<Vertex>::Iterator v = (*pgon)->begin(); v != endV; ++v) {
+            polygon.vertices.push_back(*v);
+        }
+        if (polygon.vertices.empty()) {
+            continue;
+        }
+        polygon.index = polygon.vertices[0]->polygon;
+        for (int i = 0; i < DIMENSIONS; ++i) {
+            polygon.low[i] = polygon.high[i] = polygon.vertices[0]->coord[i];
+            for (const Vertex *v : polygon.vertices) {
+                polygon.low[i] = min(polygon.low[i], v->coord[i]);
+                polygon.high[i] = max(polygon.high[i], v->coord[i]);
+            }
+        }
+
+        polygon.sign = convexSign(polygon.vertices);
+        if (polygon.sign == 0) {
+            report.nonConvex.push_back(polygon.index);
+        } else if (referenceSign == 0) {
+            referenceSign = polygon.sign;
+        } else if (polygon.sign != referenceSign) {
+            report.misoriented.push_back(polygon.index);
+        }
+        data.push_back(polygon);
+    }
+
+    // Shared vertices, by coordinates
+    set<pair<int, int>> shared;
+    unordered_map<const Vertex*, int, CoordinateHash, CoordinateEqual> owner;
+    for (int p = 0; p < (int) data.size(); ++p) {
+        for (const Vertex *v : data[p].vertices) {
+            auto inserted = owner.insert(make_pair(v, p));
+            int other = inserted.first->second;
+            if (!inserted.second && other != p) {
+                shared.insert(polygonPair(data[other].index, data[p].index));
+            }
+        }
+    }
+
+    // Bucket the edges' bounding boxes in a grid; edges of different
+    // polygons whose boxes overlap are tested exactly
+    set<pair<int, int>> overlaps;
+    vector<EdgeBox> edges;
+    for (int p = 0; p < (int) data.size(); ++p) {
+        const int size = (int) data[p].vertices.size();
+        for (int i = 0; i < size; ++i) {
+            EdgeBox edge;
+            edge.polygon = p;
+            edge.a = data[p].vertices[i];
+            edge.b = data[p].vertices[(i + 1) % size];
+            for (int j = 0; j < DIMENSIONS; ++j) {
+                edge.low[j] = min(edge.a->coord[j], edge.b->coord[j]);
+                edge.high[j] = max(edge.a->coord[j], edge.b->coord[j]);
+            }
+            edges.push_back(edge);
+        }
+    }
+    BoxGrid edgeGrid;
+    buildBoxGrid(edges, edgeGrid);
+    forEachOverlappingPair(edges, edgeGrid, [&](int e, int f) {
+        const EdgeBox &edge = edges[e];
+        const EdgeBox &other = edges[f];
+        if (other.polygon == edge.polygon) {
+            return;
+        }
+        pair<int, int> key = polygonPair(data[edge.polygon].index,
+                                         data[other.polygon].index);
+        if (overlaps.count(key) == 0 &&
+            segmentsMeet(*edge.a, *edge.b, *other.a, *other.b)) {
+            overlaps.insert(key);
+        }
+    });
+
+    // Same grid over the polygons; a convex polygon can hold another without
+    // their edges meeting, so pairs whose boxes overlap are checked for
+    // containment
+    BoxGrid polygonGrid;
+    buildBoxGrid(data, polygonGrid);
+    forEachOverlappingPair(data, polygonGrid, [&](int p, int q) {
+        const PolygonData &polygon = data[p];
+        const PolygonData &other = data[q];
+        ++report.candidatePairs;
+        pair<int, int> key = polygonPair(polygon.index, other.index);
+        if (overlaps.count(key) != 0) {
+            return;
+        }
+        // No edges meet, so one holds the other only if it holds any of its
+        // vertices
+        if ((polygon.sign != 0 && insideOrOn(polygon, *other.vertices[0])) ||
+            (other.sign != 0 && insideOrOn(other, *polygon.vertices[0]))) {
+            overlaps.insert(key);
+        }
+    });
+
+    // Pairs sharing a vertex also touch; only report them once
+    report.sharedVertices.assign(shared.begin(), shared.end());
+    for (const pair<int, int> &key : overlaps) {
+        if (shared.count(key) == 0) {
+            report.overlaps.push_back(key);
+        }
+    }
+    sort(report.nonConvex.begin(), report.nonConvex.end());
+    sort(report.misoriented.begin(), report.misoriented.end());
+
+    return report.nonConvex.empty() && report.misoriented.empty() &&
+           report.sharedVertices.empty() && report.overlaps.empty();
+}
+
+// MODIFIES: os
+// EFFECTS : Prints a one line summary of report, followed by a line for each
+//           problem found
+void printValidationReport(std::ostream &os, const ValidationReport &report) {
+    os << "Validation: " << report.candidatePairs << " candidate pairs, "
+       << report.nonConvex.size() << " non-convex, "
+       << report.misoriented.size() << " misoriented, "
+       << report.sharedVertices.size() << " sharing vertices, "
+       << report.overlaps.size() << " overlapping" << endl;
+    for (int polygon : report.nonConvex) {
+        os << "Polygon " << polygon << " is not convex" << endl;
+    }
+    for (int polygon : report.misoriented) {
+        os << "Polygon " << polygon
+           << " is oriented differently from the first polygon" << endl;
+    }
+    for (const pair<int, int> &polygons : report.sharedVertices) {
+        os << "Polygons " << polygons.first << " and " << polygons.second
+           << " share a vertex" << endl;
+    }
+    for (const pair<int, int> &polygons : report.overlaps) {
+        os << "Polygons " << polygons.first << " and " << polygons.second
+           << " overlap or touch" << endl;
+    }
+}
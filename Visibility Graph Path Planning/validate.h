@@ -0,0 +1,62 @@
+//
+//  validate.h
+//  Visibility Graph Path Planning
+//
+//  Checks the polygon preconditions of preProcess: every polygon is convex,
+//  all polygons have the same orientation, and no two polygons overlap,
+//  touch, or share a vertex. preProcess trusts these, and a violation
+//  silently produces a wrong graph. Checking every pair of polygons is
+//  quadratic, so the bounding boxes of the edges and polygons are bucketed
+//  in a uniform grid (as in point_location), and only pairs whose boxes
+//  overlap are tested exactly.
+//
+
+#ifndef validate_h
+#define validate_h
+
+#include <vector>
+#include <utility>
+#include <iostream>
+#include "preprocessing.h"
+
+// Problems found by validatePolygons. Polygons are identified by their
+// polygon index (see Vertex).
+struct ValidationReport {
+    // Polygons with fewer than 3 distinct vertices, or that are not convex
+    std::vector<int> nonConvex;
+    // Polygons whose orientation differs from the first polygon's
+    std::vector<int> misoriented;
+    // Pairs of polygons that have a vertex at the same coordinates
+    std::vector<std::pair<int, int>> sharedVertices;
+    // Pairs of polygons that overlap or touch
+    std::vector<std::pair<int, int>> overlaps;
+    // Number of pairs whose bounding boxes overlapped (tested exactly)
+    int candidatePairs;
+};
+
+// REQUIRES: polygons was read by read_polygons (or preProcess), report is
+//           empty
+// MODIFIES: report
+// EFFECTS : Checks each polygon for convexity in linear time (all turns in
+//           one direction, and the polygon winds around only once), checks
+//           that all polygons have the same orientation, finds polygons
+//           sharing a vertex with a hash of the coordinates, and finds
+//           overlapping or touching pairs: edges of different polygons whose
+//           bounding boxes overlap (found by bucketing the boxes in a uniform
+//           grid with cells about as large as the mean box) are tested for a
+//           common point, then polygons whose bounding boxes overlap (found
+//           the same way) are tested for containment. All tests use the
+//           exact orientation predicate. Takes O(N + C) time for N vertices
+//           and C pairs of edges (or polygons) sharing a grid cell, plus
+//           linear time per candidate polygon pair. C is near N unless many
+//           edges crowd into the same few cells. Returns true if no problems
+//           were found.
+bool validatePolygons(List<List<Vertex>> const &polygons,
+                      ValidationReport &report);
+
+// MODIFIES: os
+// EFFECTS : Prints a one line summary of report, followed by a line for each
+//           problem found
+void printValidationReport(std::ostream &os, const ValidationReport &report);
+
+#endif /* validate_h */
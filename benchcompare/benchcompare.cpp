@@ -0,0 +1,412 @@
+//
+//  benchcompare.cpp
+//  benchcompare
+//
+//  Compares two sets of testing results (CSV records, see results.h in the
+//  path planning code) made with the same TESTSEED, so both sides ran the
+//  same maps and searches. Each side may be several runs. A row's value in
+//  each run is paired with the same row's value in the same run of the other
+//  side, and each metric's change is summarized over those pairs as a
+//  geometric mean ratio with a 95% confidence interval. Memory is the whole
+//  process's resident set, not a per-search measurement, so it is compared
+//  once per run instead. The program exits with status 1 if any metric got
+//  significantly worse by more than the threshold, so it can gate a build.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace std;
+
+// Columns of each record type (see results.h)
+static const size_t GRAPH_COLUMNS = 13;
+static const size_t SEARCH_COLUMNS = 12;
+
+// A column compared between the two sides, from "graph" or "search" rows.
+// A per-run metric is compared by its largest value in each run rather than
+// row by row.
+struct Metric {
+    const char *name;
+    const char *record;
+    size_t column;
+    bool perRun;
+};
+
+static const Metric METRICS[] = {
+    {"preprocess_clocks", "graph", 12, false},
+    {"graph_edges", "graph", 6, false},
+    {"nodes_expanded", "search", 8, false},
+    {"search_clocks", "search", 9, false},
+    {"memory_bytes", "search", 11, true}
+};
+static const int NUM_METRICS = sizeof(METRICS) / sizeof(METRICS[0]);
+
+// Values of one row in each run (results file) of one side, in the order the
+// files were given; empty for a run without the row
+struct Row {
+    vector<vector<double>> runs;
+};
+
+// Rows of one side by key: "graph <test>" or "search <test> <search>"
+typedef map<string, Row> ResultSet;
+
+// REQUIRES: line is a row of comma-separated values
+// MODIFIES: fields
+// EFFECTS : Replaces fields with the values of line
+void splitRow(const string &line, vector<string> &fields);
+
+// REQUIRES: run >= 0
+// MODIFIES: results
+// EFFECTS : Adds every row of the CSV results file filename to results as
+//           the values of run number run. Returns false if the file can't be
+//           opened or is not a results file.
+bool readResults(const string &filename, int run, ResultSet &results);
+
+// REQUIRES: row has values in at least one run
+// EFFECTS : Returns the average of column of row over the runs that have it
+double average(const Row &row, size_t column);
+
+// EFFECTS : Returns true if row has values in run
+bool hasRun(const Row &row, int run);
+
+// EFFECTS : Returns true if the row with key should be compared for metric:
+//           it is of metric's record type, is not in an excluded test, and
+//           (for searches) needed A* on both sides
+bool comparable(const Metric &metric, const string &key, const Row &before,
+                const Row &after, const map<string, bool> &excludedTests);
+
+// REQUIRES: degrees > 0
+// EFFECTS : Returns the two-sided 95% critical value of Student's t
+//           distribution with degrees degrees of freedom
+double tCritical(int degrees);
+
+// REQUIRES: excludedTests holds the tests whose maps differ
+// MODIFIES: os
+// EFFECTS : Prints a line comparing metric between baseline and candidate:
+//           the number of pairs, the mean of each side, the geometric mean
+//           change and its 95% confidence interval (in percent), and a
+//           verdict. The pairs are each row's value in run i of both sides
+//           (or, for a per-run metric, its largest value in run i), for
+//           every run i both sides have. Pairs where either value is 0 are
+//           left out (a ratio needs both). Returns true if the change is a
+//           significant regression larger than threshold percent.
+bool compareMetric(const Metric &metric, const ResultSet &baseline,
+                   const ResultSet &candidate,
+                   const map<string, bool> &excludedTests, double threshold,
+                   ostream &os);
+
+int main(int argc, char *argv[]) {
+
+    // Threshold (percent) a significant regression must exceed to fail
+    double threshold = 5;
+    int arg = 1;
+    if (arg + 1 < argc && string(argv[arg]) == "-t") {
+        threshold = atof(argv[arg + 1]);
+        arg += 2;
+    }
+    if (argc - arg != 2) {
+        cout << "Usage: " << argv[0] << " [-t percent] baseline.csv[,...] "
+             << "candidate.csv[,...]" << endl;
+        return 2;
+    }
+
+    // Each side may be several runs (comma separated), paired in order
+    ResultSet sides[2];
+    int runs[2];
+    for (int side = 0; side < 2; ++side) {
+        vector<string> filenames;
+        splitRow(argv[arg + side], filenames);
+        runs[side] = (int) filenames.size();
+        for (size_t i = 0; i < filenames.size(); ++i) {
+            if (!readResults(filenames[i], (int) i, sides[side])) {
+                cout << "Error reading results file: " << filenames[i]
+                     << endl;
+                return 2;
+            }
+        }
+    }
+    const ResultSet &baseline = sides[0];
+    const ResultSet &candidate = sides[1];
+
+    // The same seed must have produced the same maps (polygon and vertex
+    // counts) and paths; differences mean the two sides are not comparable
+    map<string, bool> excludedTests;
+    int pairedTests = 0;
+    int differentPaths = 0;
+    for (ResultSet::const_iterator it = baseline.begin();
+         it != baseline.end(); ++it) {
+        ResultSet::const_iterator match = candidate.find(it->first);
+        if (match == candidate.end()) {
+            continue;
+        }
+        istringstream key(it->first);
+        string record, test;
+        key >> record >> test;
+        if (record == "graph") {
+            if (average(it->second, 2) != average(match->second, 2) ||
+                average(it->second, 3) != average(match->second, 3)) {
+                excludedTests[test] = true;
+            } else {
+                ++pairedTests;
+            }
+        } else if (excludedTests.count(test)) {
+            continue;
+        } else if (average(it->second, 3) != average(match->second, 3) ||
+                   fabs(average(it->second, 5) - average(match->second, 5))
+                   > 1e-9 * max(1.0, fabs(average(it->second, 5)))) {
+            ++differentPaths;
+        }
+    }
+    if (pairedTests == 0) {
+        cout << "The result sets have no tests in common (were they run with "
+             << "the same TESTSEED?)" << endl;
+        return 2;
+    }
+    cout << "Tests compared: " << pairedTests << endl;
+    if (!excludedTests.empty()) {
+        cout << "Tests left out (different maps): " << excludedTests.size()
+             << endl;
+    }
+    if (differentPaths > 0) {
+        cout << "Warning: " << differentPaths << " searches found a different "
+             << "path length or success" << endl;
+    }
+    cout << "Runs paired: " << min(runs[0], runs[1]) << endl;
+    cout << "Regression threshold: " << threshold << "%" << endl;
+    // Say what the interval measures
+    if (min(runs[0], runs[1]) == 1) {
+        cout << "Intervals are over tests and searches (one run per side), "
+             << "so they show how consistent the change is across them, not "
+             << "run-to-run noise; memory_bytes needs several runs" << endl;
+    } else {
+        cout << "Intervals are over every test and search in every paired "
+             << "run; memory_bytes is compared once per run" << endl;
+    }
+    cout << endl;
+
+    cout << left << setw(20) << "metric" << right << setw(7) << "pairs"
+         << setw(14) << "baseline" << setw(14) << "candidate" << setw(10)
+         << "change" << setw(22) << "95% CI" << "  verdict" << endl;
+    bool failed = false;
+    for (int i = 0; i < NUM_METRICS; ++i) {
+        if (compareMetric(METRICS[i], baseline, candidate, excludedTests,
+                          threshold, cout)) {
+            failed = true;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
+
+void splitRow(const string &line, vector<string> &fields) {
+    fields.clear();
+    size_t begin = 0;
+    while (begin <= line.size()) {
+        size_t end = line.find(',', begin);
+        if (end == string::npos) {
+            end = line.size();
+        }
+        fields.push_back(line.substr(begin, end - begin));
+        begin = end + 1;
+    }
+}
+
+bool readResults(const string &filename, int run, ResultSet &results) {
+    ifstream fin(filename);
+    if (!fin) {
+        return false;
+    }
+    string line;
+    vector<string> fields;
+    while (getline(fin, line)) {
+        // Skip the column names and blank lines
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        splitRow(line, fields);
+        string key;
+        if (fields[0] == "graph" && fields.size() == GRAPH_COLUMNS) {
+            key = "graph " + fields[1];
+        } else if (fields[0] == "search" && fields.size() == SEARCH_COLUMNS) {
+            key = "search " + fields[1] + " " + fields[2];
+        } else {
+            return false;
+        }
+        Row &row = results[key];
+        if ((int) row.runs.size() <= run) {
+            row.runs.resize(run + 1);
+        }
+        vector<double> &values = row.runs[run];
+        values.assign(fields.size(), 0);
+        for (size_t i = 1; i < fields.size(); ++i) {
+            values[i] = atof(fields[i].c_str());
+        }
+    }
+    return true;
+}
+
+double average(const Row &row, size_t column) {
+    double sum = 0;
+    int count = 0;
+    for (size_t run = 0; run < row.runs.size(); ++run) {
+        if (!row.runs[run].empty()) {
+            sum += row.runs[run][column];
+            ++count;
+        }
+    }
+    return sum / count;
+}
+
+bool hasRun(const Row &row, int run) {
+    return run < (int) row.runs.size() && !row.runs[run].empty();
+}
+
+bool comparable(const Metric &metric, const string &key, const Row &before,
+                const Row &after, const map<string, bool> &excludedTests) {
+    istringstream keyFields(key);
+    string record, test;
+    keyFields >> record >> test;
+    if (record != metric.record || excludedTests.count(test)) {
+        return false;
+    }
+    // Searches that did not need A* have nothing to compare
+    return record != "search" ||
+           (average(before, 4) == 0 && average(after, 4) == 0);
+}
+
+double tCritical(int degrees) {
+    static const double table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+        2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101,
+        2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052,
+        2.048, 2.045, 2.042};
+    if (degrees <= 30) {
+        return table[degrees - 1];
+    } else if (degrees <= 60) {
+        return 2.000;
+    } else if (degrees <= 120) {
+        return 1.980;
+    }
+    return 1.960;
+}
+
+bool compareMetric(const Metric &metric, const ResultSet &baseline,
+                   const ResultSet &candidate,
+                   const map<string, bool> &excludedTests, double threshold,
+                   ostream &os) {
+    // Values of each pair
+    vector<double> befores;
+    vector<double> afters;
+    int runs = 0;
+    for (ResultSet::const_iterator it = baseline.begin();
+         it != baseline.end(); ++it) {
+        runs = max(runs, (int) it->second.runs.size());
+    }
+    if (metric.perRun) {
+        vector<double> peaks[2];
+        peaks[0].assign(runs, 0);
+        peaks[1].assign(runs, 0);
+        for (ResultSet::const_iterator it = baseline.begin();
+             it != baseline.end(); ++it) {
+            ResultSet::const_iterator match = candidate.find(it->first);
+            if (match == candidate.end() ||
+                !comparable(metric, it->first, it->second, match->second,
+                            excludedTests)) {
+                continue;
+            }
+            for (int run = 0; run < runs; ++run) {
+                if (hasRun(it->second, run) && hasRun(match->second, run)) {
+                    peaks[0][run] = max(peaks[0][run],
+                                        it->second.runs[run][metric.column]);
+                    peaks[1][run] = max(peaks[1][run],
+                                        match->second.runs[run]
+                                                          [metric.column]);
+                }
+            }
+        }
+        befores = peaks[0];
+        afters = peaks[1];
+    } else {
+        for (ResultSet::const_iterator it = baseline.begin();
+             it != baseline.end(); ++it) {
+            ResultSet::const_iterator match = candidate.find(it->first);
+            if (match == candidate.end() ||
+                !comparable(metric, it->first, it->second, match->second,
+                            excludedTests)) {
+                continue;
+            }
+            for (int run = 0; run < runs; ++run) {
+                if (hasRun(it->second, run) && hasRun(match->second, run)) {
+                    befores.push_back(it->second.runs[run][metric.column]);
+                    afters.push_back(match->second.runs[run][metric.column]);
+                }
+            }
+        }
+    }
+
+    // Log of candidate / baseline for each pair, so a 2x slowdown and a 2x
+    // speedup weigh the same
+    vector<double> logRatios;
+    double baselineSum = 0;
+    double candidateSum = 0;
+    for (size_t i = 0; i < befores.size(); ++i) {
+        if (befores[i] <= 0 || afters[i] <= 0) {
+            continue;
+        }
+        logRatios.push_back(log(afters[i] / befores[i]));
+        baselineSum += befores[i];
+        candidateSum += afters[i];
+    }
+
+    int n = (int) logRatios.size();
+    os << left << setw(20) << metric.name << right << setw(7) << n;
+    if (n == 0) {
+        os << endl;
+        return false;
+    }
+    double mean = 0;
+    for (int i = 0; i < n; ++i) {
+        mean += logRatios[i];
+    }
+    mean /= n;
+    double variance = 0;
+    for (int i = 0; i < n; ++i) {
+        variance += (logRatios[i] - mean) * (logRatios[i] - mean);
+    }
+
+    os << fixed << setprecision(1) << setw(14) << baselineSum / n << setw(14)
+       << candidateSum / n << setprecision(2) << setw(9)
+       << (exp(mean) - 1) * 100 << "%";
+    // One pair has no spread to estimate the interval from
+    if (n < 2) {
+        os << setw(22) << "n/a" << endl;
+        return false;
+    }
+    double halfWidth = tCritical(n - 1) * sqrt(variance / (n - 1) / n);
+    double low = (exp(mean - halfWidth) - 1) * 100;
+    double high = (exp(mean + halfWidth) - 1) * 100;
+    ostringstream interval;
+    interval << fixed << setprecision(2) << "[" << low << "%, " << high
+             << "%]";
+    os << setw(22) << interval.str();
+
+    // Significant when the whole interval is on one side of no change
+    bool regression = low > 0 && (exp(mean) - 1) * 100 > threshold;
+    if (regression) {
+        os << "  REGRESSION";
+    } else if (low > 0) {
+        os << "  worse (under threshold)";
+    } else if (high < 0) {
+        os << "  better";
+    }
+    os << endl;
+    return regression;
+}
@@ -10,6 +10,8 @@
 #include <string>
 #include <fstream>
 #include <algorithm>
+#include <sstream>
+#include <vector>
 
 using namespace std;
 
@@ -34,6 +36,18 @@ void AStarSuccessFailure(istream &is, ostream &os);
 //           (see README).
 void AStarHelper(istream &is, ostream &os);
 
+// REQUIRES: 'is' is a valid input stream at the beginning of a CSV results
+//           file (see results.h). visGraphOs and AStarOs are valid output
+//           streams that support seekp, at their beginnings.
+// MODIFIES: is, visGraphOs, AStarOs
+// EFFECTS : Produces the same two outputs as visGraphHelper, and
+//           AStarSuccessFailure followed by AStarHelper, in one pass over is,
+//           holding one row in memory at a time. The success and failure
+//           counts are written into space reserved at the top of AStarOs once
+//           every row has been read. Returns false if is is not a results
+//           file.
+bool CSVHelper(istream &is, ostream &visGraphOs, ostream &AStarOs);
+
 int main() {
     
     // Take in outupt file
@@ -53,6 +67,17 @@ int main() {
     // Create a postprocessed file
     ofstream postProccessFout("post_process_vis_graph.out");
     
+    // CSV results are processed in a single pass
+    if (toProcessFilename.size() > 4 &&
+        toProcessFilename.substr(toProcessFilename.size() - 4) == ".csv") {
+        ofstream AStarFout("post_process_AStar.out");
+        if (!CSVHelper(toProcessFin, postProccessFout, AStarFout)) {
+            cout << "Not a results file: " << toProcessFilename << endl;
+            return 1;
+        }
+        return 0;
+    }
+    
     // Send to helper function
     visGraphHelper(toProcessFin, postProccessFout);
     toProcessFin.close();
@@ -185,3 +210,76 @@ void AStarHelper(istream &is, ostream &os) {
         }
     }
 }
+
+// REQUIRES: line is one row of a CSV results file
+// MODIFIES: fields
+// EFFECTS : Splits line at its commas into fields
+static void splitRow(const string &line, vector<string> &fields) {
+    fields.clear();
+    size_t begin = 0;
+    while (true) {
+        size_t end = line.find(',', begin);
+        if (end == string::npos) {
+            fields.push_back(line.substr(begin));
+            return;
+        }
+        fields.push_back(line.substr(begin, end - begin));
+        begin = end + 1;
+    }
+}
+
+bool CSVHelper(istream &is, ostream &visGraphOs, ostream &AStarOs) {
+    // Columns of each record type (see results.h)
+    const size_t graphColumns = 13;
+    const size_t searchColumns = 12;
+    // Room for the success and failure counts at the top of AStarOs
+    const int countWidth = 40;
+    
+    AStarOs << string(countWidth, ' ') << '\n';
+    
+    int successCount = 0;
+    int failCount = 0;
+    string line;
+    vector<string> fields;
+    while (getline(is, line)) {
+        // Skip the column names and blank lines
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        splitRow(line, fields);
+        if (fields[0] == "graph" && fields.size() == graphColumns) {
+            // The 8 values after test, polygons, vertices and generation
+            // clocks are those of interest (see README)
+            for (size_t i = 5; i < graphColumns; ++i) {
+                visGraphOs << fields[i] << " ";
+            }
+            visGraphOs << '\n';
+        } else if (fields[0] == "search" && fields.size() == searchColumns) {
+            if (fields[3] != "1") {
+                ++failCount;
+                continue;
+            }
+            ++successCount;
+            // Searches that needed A* have the 6 values of interest after
+            // distance (see README)
+            if (fields[4] == "0") {
+                for (size_t i = 6; i < searchColumns; ++i) {
+                    AStarOs << fields[i] << " ";
+                }
+                AStarOs << '\n';
+            }
+        } else {
+            return false;
+        }
+    }
+    
+    // Fill in the counts
+    // Note: Print 0s to ensure rectangular matrix for MATLAB
+    ostringstream counts;
+    counts << successCount << " " << failCount << " 0 0 0 0 ";
+    AStarOs.seekp(0);
+    AStarOs << counts.str()
+            << string(countWidth - min(countWidth, (int) counts.str().size()),
+                      ' ');
+    return true;
+}